@@ -0,0 +1,205 @@
+#include "async_writer.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef struct _queued_job
+{
+    uint64_t seq;
+    std::unique_ptr<async_job> job;
+} queued_job_t;
+
+static std::vector<std::thread> workers;
+static std::mutex queue_mutex;
+static std::condition_variable queue_changed;
+static std::deque<queued_job_t> queue;
+static size_t queue_capacity = ASYNC_WRITER_QUEUE_SIZE;
+static size_t jobs_in_flight = 0;
+static bool stopping = false;
+
+// jobs that have run, keyed by sequence number, null when run () failed
+static std::map<uint64_t, std::unique_ptr<async_job> > finished;
+static uint64_t next_submit_seq = 0;
+static uint64_t next_commit_seq = 0;
+
+// held while committing, so commits never overlap
+static std::mutex commit_mutex;
+
+static void
+report_job_error (const std::exception &e)
+{
+    // the compiler has moved on, so report and keep going
+    std::cerr << "[gimple-extractor] error: " << e.what () << std::endl;
+}
+
+/* Commit every finished job whose predecessors have all been committed.  */
+static void
+commit_finished_jobs ()
+{
+    std::lock_guard<std::mutex> commit_lock (commit_mutex);
+
+    for (;;)
+        {
+            std::unique_ptr<async_job> job;
+
+            {
+                std::lock_guard<std::mutex> lock (queue_mutex);
+                auto it = finished.find (next_commit_seq);
+                if (it == finished.end ())
+                    return;
+
+                job = std::move (it->second);
+                finished.erase (it);
+            }
+
+            if (job)
+                {
+                    try
+                        {
+                            job->commit ();
+                        }
+                    catch (const std::exception &e)
+                        {
+                            report_job_error (e);
+                        }
+                }
+
+            job.reset ();
+
+            {
+                std::lock_guard<std::mutex> lock (queue_mutex);
+                next_commit_seq++;
+                jobs_in_flight--;
+            }
+            queue_changed.notify_all ();
+        }
+}
+
+static void
+worker_main ()
+{
+    for (;;)
+        {
+            queued_job_t queued;
+
+            {
+                std::unique_lock<std::mutex> lock (queue_mutex);
+                queue_changed.wait (lock,
+                                    [] { return stopping || !queue.empty (); });
+                if (queue.empty ())
+                    return;
+
+                queued = std::move (queue.front ());
+                queue.pop_front ();
+            }
+
+            try
+                {
+                    queued.job->run ();
+                }
+            catch (const std::exception &e)
+                {
+                    report_job_error (e);
+                    queued.job.reset ();
+                }
+
+            {
+                std::lock_guard<std::mutex> lock (queue_mutex);
+                finished[queued.seq] = std::move (queued.job);
+            }
+
+            commit_finished_jobs ();
+        }
+}
+
+/* GCC leaves through exit () on fatal errors (e.g. a missing #include)
+   without running PLUGIN_FINISH, and destroying a joinable std::thread
+   calls std::terminate.  Registered after workers was constructed, so it
+   runs before the vector is destroyed.  */
+static void
+stop_at_exit ()
+{
+    async_writer_stop ();
+}
+
+void
+async_writer_start (size_t threads, size_t queue_size)
+{
+    static bool stop_registered = false;
+
+    if (!workers.empty ())
+        return;
+
+    if (!stop_registered)
+        {
+            atexit (stop_at_exit);
+            stop_registered = true;
+        }
+
+    if (threads < 1)
+        threads = 1;
+
+    // every worker needs a job to be busy
+    queue_capacity = queue_size > threads ? queue_size : threads;
+    stopping = false;
+
+    for (size_t i = 0; i < threads; i++)
+        workers.push_back (std::thread (worker_main));
+}
+
+bool
+async_writer_is_running ()
+{
+    return !workers.empty ();
+}
+
+void
+async_writer_submit (std::unique_ptr<async_job> job)
+{
+    {
+        std::unique_lock<std::mutex> lock (queue_mutex);
+        queue_changed.wait (lock,
+                            [] { return jobs_in_flight < queue_capacity; });
+
+        queued_job_t queued;
+        queued.seq = next_submit_seq++;
+        queued.job = std::move (job);
+        queue.push_back (std::move (queued));
+        jobs_in_flight++;
+    }
+    queue_changed.notify_all ();
+}
+
+void
+async_writer_drain ()
+{
+    if (workers.empty ())
+        return;
+
+    std::unique_lock<std::mutex> lock (queue_mutex);
+    queue_changed.wait (lock, [] { return jobs_in_flight == 0; });
+}
+
+void
+async_writer_stop ()
+{
+    if (workers.empty ())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock (queue_mutex);
+        stopping = true;
+    }
+    queue_changed.notify_all ();
+
+    for (auto &worker : workers)
+        worker.join ();
+    workers.clear ();
+}
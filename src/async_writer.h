@@ -0,0 +1,49 @@
+#ifndef H_ASYNC_WRITER_
+#define H_ASYNC_WRITER_
+
+#include <cstddef>
+#include <memory>
+
+/*
+ * Background writer pool.
+ *
+ * Serializing and writing a function is moved off the compiler's critical
+ * path: execute () hands the extracted function over as an async_job.
+ * Worker threads run () several jobs concurrently (serialization only
+ * touches the job's own data), then each job is commit ()ed, one at a
+ * time and in submission order, so the output does not depend on
+ * scheduling. The number of jobs in flight is bounded so that a slow disk
+ * throttles the compiler instead of letting extracted functions pile up
+ * in memory.
+ *
+ * This file does not include the GCC headers (they poison parts of the
+ * standard library used by <thread>), jobs only see the data they own.
+ */
+
+#define ASYNC_WRITER_QUEUE_SIZE 16
+
+class async_job
+{
+  public:
+    virtual ~async_job () {}
+
+    /* Runs on any worker, concurrently with other jobs.  */
+    virtual void run () = 0;
+
+    /* Runs after run (), in submission order and never concurrently.  */
+    virtual void commit () {}
+};
+
+void async_writer_start (size_t threads, size_t queue_size);
+bool async_writer_is_running ();
+
+/* Queue JOB, blocking while QUEUE_SIZE jobs are already in flight.  */
+void async_writer_submit (std::unique_ptr<async_job> job);
+
+/* Wait until every submitted job has been committed.  */
+void async_writer_drain ();
+
+/* Drain the queue and join the worker threads.  */
+void async_writer_stop ();
+
+#endif
@@ -0,0 +1,135 @@
+#include "call_graph.h"
+#include <algorithm>
+
+static void
+append_u32 (std::string &out, uint32_t value)
+{
+    char bytes[4];
+    for (int i = 0; i < 4; i++)
+        bytes[i] = (value >> (8 * i)) & 0xff;
+    out.append (bytes, sizeof (bytes));
+}
+
+static void
+append_u64 (std::string &out, uint64_t value)
+{
+    char bytes[8];
+    for (int i = 0; i < 8; i++)
+        bytes[i] = (value >> (8 * i)) & 0xff;
+    out.append (bytes, sizeof (bytes));
+}
+
+static uint32_t
+append_string (std::string &strings, const std::string &value)
+{
+    uint32_t offset = strings.size ();
+    strings.append (value);
+    strings.push_back ('\0');
+    return offset;
+}
+
+uint32_t
+call_graph_add_node (call_graph_t &graph, const std::string &asm_name,
+                     uint32_t flags)
+{
+    auto it = graph.node_index.find (asm_name);
+    if (it != graph.node_index.end ())
+        {
+            graph.nodes[it->second].flags |= flags;
+            return it->second;
+        }
+
+    uint32_t index = graph.nodes.size ();
+    graph.node_index[asm_name] = index;
+
+    call_graph_node_t node;
+    node.asm_name = asm_name;
+    node.flags = flags;
+    graph.nodes.push_back (std::move (node));
+
+    return index;
+}
+
+void
+call_graph_add_edge (call_graph_t &graph, uint32_t caller, uint32_t callee,
+                     uint32_t line)
+{
+    call_graph_edge_t edge;
+    edge.callee = callee;
+    edge.line = line;
+    graph.nodes[caller].edges.push_back (edge);
+}
+
+std::string
+call_graph_to_string (const call_graph_t &graph)
+{
+    std::string strings;
+    uint32_t unit = append_string (strings, graph.unit);
+
+    std::string nodes;
+    std::string edges;
+    uint32_t edge_count = 0;
+
+    for (auto &node : graph.nodes)
+        {
+            // inline copies of a function report its calls again
+            std::vector<call_graph_edge_t> node_edges = node.edges;
+            std::sort (node_edges.begin (), node_edges.end (),
+                       [] (const call_graph_edge_t &a,
+                           const call_graph_edge_t &b) {
+                           if (a.line != b.line)
+                               return a.line < b.line;
+                           return a.callee < b.callee;
+                       });
+            node_edges.erase (
+                std::unique (node_edges.begin (), node_edges.end (),
+                             [] (const call_graph_edge_t &a,
+                                 const call_graph_edge_t &b) {
+                                 return a.line == b.line
+                                        && a.callee == b.callee;
+                             }),
+                node_edges.end ());
+
+            append_u32 (nodes, append_string (strings, node.asm_name));
+            append_u32 (nodes, node.flags);
+            append_u32 (nodes, edge_count);
+            append_u32 (nodes, node_edges.size ());
+
+            for (auto &edge : node_edges)
+                {
+                    append_u32 (edges, edge.callee);
+                    append_u32 (edges, edge.line);
+                }
+            edge_count += node_edges.size ();
+        }
+
+    // node and edge entries are 8 bytes multiples, so only the strings
+    // need padding to keep the next block aligned
+    strings.resize ((strings.size () + 7) & ~static_cast<size_t> (7), '\0');
+
+    std::string out;
+    uint64_t block_size = 32 + nodes.size () + edges.size () + strings.size ();
+    out.reserve (block_size);
+
+    out.append (CALL_GRAPH_MAGIC, 4);
+    append_u32 (out, CALL_GRAPH_VERSION);
+    append_u32 (out, unit);
+    append_u32 (out, graph.nodes.size ());
+    append_u32 (out, edge_count);
+    append_u32 (out, strings.size ());
+    append_u64 (out, block_size);
+
+    out += nodes;
+    out += edges;
+    out += strings;
+
+    return out;
+}
+
+void
+call_graph_clear (call_graph_t &graph)
+{
+    graph.unit.clear ();
+    graph.nodes.clear ();
+    graph.node_index.clear ();
+}
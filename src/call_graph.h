@@ -0,0 +1,75 @@
+#ifndef H_CALL_GRAPH_
+#define H_CALL_GRAPH_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Call graph of a translation unit.
+ *
+ * Nodes are functions, keyed by assembler name: the unit's functions and
+ * every function they call. The graph is written as a single block of
+ * fixed-width little-endian integers, 8-byte aligned, so that the blocks
+ * of all units can be concatenated into one file and used in place from
+ * an mmap:
+ *
+ *   header   "GXCG" | u32 version | u32 unit | u32 node_count
+ *            | u32 edge_count | u32 string_size | u64 block_size
+ *   nodes    (u32 asm_name | u32 flags | u32 first_edge | u32 edge_count)*
+ *   edges    (u32 callee | u32 line)*
+ *   strings  NUL terminated, padded to block_size
+ *
+ * `unit` and `asm_name` are offsets into the strings. A node's edges are
+ * edges[first_edge, first_edge + edge_count), sorted by line. `callee` is a
+ * node index of the same block, or CALL_GRAPH_INDIRECT / CALL_GRAPH_VIRTUAL
+ * for a call through a pointer or a virtual call. Local functions
+ * (no CALL_GRAPH_NODE_PUBLIC) are only the same function within a block.
+ */
+
+#define CALL_GRAPH_MAGIC "GXCG"
+#define CALL_GRAPH_VERSION 1
+
+// the function is defined in the unit
+#define CALL_GRAPH_NODE_DEFINED 0x1
+#define CALL_GRAPH_NODE_PUBLIC 0x2
+#define CALL_GRAPH_NODE_ADDRESS_TAKEN 0x4
+#define CALL_GRAPH_NODE_COMDAT 0x8
+
+#define CALL_GRAPH_INDIRECT 0xffffffffU
+#define CALL_GRAPH_VIRTUAL 0xfffffffeU
+
+typedef struct _call_graph_edge
+{
+    uint32_t callee = CALL_GRAPH_INDIRECT;
+    uint32_t line = 0;
+} call_graph_edge_t;
+
+typedef struct _call_graph_node
+{
+    std::string asm_name;
+    uint32_t flags = 0;
+    std::vector<call_graph_edge_t> edges;
+} call_graph_node_t;
+
+typedef struct _call_graph
+{
+    std::string unit;
+    std::vector<call_graph_node_t> nodes;
+    std::unordered_map<std::string, uint32_t> node_index;
+} call_graph_t;
+
+/* Index of the node ASM_NAME, added on first use.  FLAGS are or'ed into
+   the node's flags.  */
+uint32_t call_graph_add_node (call_graph_t &graph, const std::string &asm_name,
+                              uint32_t flags);
+void call_graph_add_edge (call_graph_t &graph, uint32_t caller,
+                          uint32_t callee, uint32_t line);
+
+/* The block described above, duplicate edges are dropped.  */
+std::string call_graph_to_string (const call_graph_t &graph);
+
+void call_graph_clear (call_graph_t &graph);
+
+#endif
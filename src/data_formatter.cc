@@ -1,80 +1,914 @@
-#include "ext/json11.hpp"
-#include "ext/msgpack11.hpp"
 #include "data_formatter.h"
 #include "data_formatter_json.h"
 #include "data_formatter_msgpack.h"
-using namespace json11;
-using namespace msgpack11;
+#include <memory>
 
 
-std::string
-function_to_string_dump (std::vector<gimple_stmt_data> &stmt_data_list,
-                         std::vector<basicblock_t> &basic_block_list,
-                         function_data_t &fn_data, std::string data_format)
+static const char *const data_value_type_names[] = {
+    "simple",
+    "complex",
+    "type_ref",
+};
+
+static std::unique_ptr<data_writer>
+make_data_writer (std::string &out, std::string data_format,
+                  std::string data_encoding)
 {
+    std::unique_ptr<data_writer> writer;
+
     if (data_format == "json")
-        return function_to_string_dump_json (stmt_data_list, basic_block_list,
-                                             fn_data);
+        writer.reset (new json_data_writer (out));
 
     if (data_format == "msgpack")
-        return function_to_string_dump_msgpack (stmt_data_list, basic_block_list,
-                                                fn_data);
+        writer.reset (new msgpack_data_writer (out));
+
+    if (writer)
+        writer->compact = (data_encoding == "compact");
+
+    return writer;
+}
 
-    return std::string ("");
+std::string
+function_to_string_dump (extract_vector<gimple_stmt_data> &stmt_data_list,
+                         extract_vector<basicblock_t> &basic_block_list,
+                         function_data_t &fn_data, cfg_info_t &cfg_info,
+                         std::string data_format, std::string data_encoding)
+{
+    std::string out;
+    std::unique_ptr<data_writer> writer
+        = make_data_writer (out, data_format, data_encoding);
+
+    if (writer)
+        write_function (*writer, stmt_data_list, basic_block_list, fn_data,
+                        cfg_info);
+
+    return out;
 }
 
 std::string
-function_to_string_dump_json (std::vector<gimple_stmt_data> &stmt_data_list,
-                              std::vector<basicblock_t> &basic_block_list,
-                              function_data_t &fn_data)
+type_table_to_string_dump (type_table_t &type_table, std::string data_format,
+                           std::string data_encoding)
 {
-    std::vector<Json> gimple_json_list;
-    std::vector<Json> basic_block_json_list;
+    std::string out;
+    std::unique_ptr<data_writer> writer
+        = make_data_writer (out, data_format, data_encoding);
+
+    if (writer)
+        write_type_table (*writer, type_table);
+
+    return out;
+}
+
+std::string
+symbol_table_to_string_dump (symbol_table_t &symbol_table,
+                             std::string data_format,
+                             std::string data_encoding)
+{
+    std::string out;
+    std::unique_ptr<data_writer> writer
+        = make_data_writer (out, data_format, data_encoding);
+
+    if (writer)
+        write_symbol_table (*writer, symbol_table);
+
+    return out;
+}
+
+/*
+ * Every map below lists its keys in sorted order, see data_writer.h.  The
+ * compact "strings" table always comes last since its ids are assigned
+ * while the rest of the file is written.
+ */
+
+void
+write_function (data_writer &writer,
+                extract_vector<gimple_stmt_data> &stmt_data_list,
+                extract_vector<basicblock_t> &basic_block_list,
+                function_data_t &fn_data, cfg_info_t &cfg_info)
+{
+    bool has_cfg_info = !cfg_info.bb_idom.empty ();
+    writer.begin_map ((writer.compact ? 4 : 3) + (has_cfg_info ? 1 : 0));
+
+    writer.key ("basicblocks");
+    writer.begin_array (basic_block_list.size ());
+    for (auto &bb_data : basic_block_list)
+        {
+            write_bb_data (writer, bb_data);
+        }
+    writer.end_array ();
 
-    for (auto &stmt_data : stmt_data_list)
+    if (has_cfg_info)
         {
-            Json stmt_data_object = stmt_data_to_json_object (stmt_data);
-            gimple_json_list.push_back (stmt_data_object);
+            writer.key ("cfg_info");
+            write_cfg_info (writer, cfg_info);
         }
 
-    for (auto &bb_data : basic_block_list)
+    writer.key ("function_info");
+    write_function_data (writer, fn_data);
+
+    writer.key ("gimples");
+    write_stmts_data (writer, stmt_data_list);
+
+    if (writer.compact)
         {
-            Json bb_data_object = bb_data_to_json_object (bb_data);
-            basic_block_json_list.push_back (bb_data_object);
+            writer.key ("strings");
+            writer.write_string_table ();
         }
 
-    Json data = Json::object{
-        { "function_info", function_data_to_json_object (fn_data) },
-        { "gimples", gimple_json_list },
-        { "basicblocks", basic_block_json_list },
-    };
-    return data.dump ();
+    writer.end_map ();
 }
 
-std::string
-function_to_string_dump_msgpack (std::vector<gimple_stmt_data> &stmt_data_list,
-                                 std::vector<basicblock_t> &basic_block_list,
-                                 function_data_t &fn_data)
+void
+write_cfg_info (data_writer &writer, cfg_info_t &cfg_info)
+{
+    writer.begin_map (7);
+    writer.key ("bb_idom");
+    writer.value (cfg_info.bb_idom);
+    writer.key ("bb_ipdom");
+    writer.value (cfg_info.bb_ipdom);
+    writer.key ("bb_loop");
+    writer.value (cfg_info.bb_loop);
+    writer.key ("loop_depth");
+    writer.value (cfg_info.loop_depth);
+    writer.key ("loop_header");
+    writer.value (cfg_info.loop_header);
+    writer.key ("loop_latch");
+    writer.value (cfg_info.loop_latch);
+    writer.key ("loop_outer");
+    writer.value (cfg_info.loop_outer);
+    writer.end_map ();
+}
+
+static void write_data_value_list (data_writer &writer,
+                                   const extract_vector<data_value_t> &dvalues);
+
+/*
+ * Compact data value: punctuation tokens are a bare opcode when their header
+ * matches the previous value in the same list, everything else is a map of
+ *
+ *   "h"  [code_class, code_name, is_expr, operand_length], only on change
+ *   "o"  token opcode
+ *   "t"  type_id of a type_ref
+ *   "v"  string for simple values, array of values for complex ones
+ */
+static void
+write_compact_data_value (data_writer &writer, const data_value_t &dvalue)
 {
-    std::vector<MsgPack> gimple_json_list;
-    std::vector<MsgPack> basic_block_json_list;
+    data_writer::value_header &last = writer.last_header;
+    bool header_changed = last.code_class != dvalue.code_class
+                          || last.code_name != dvalue.code_name
+                          || last.is_expr != dvalue.is_expr
+                          || last.operand_length != dvalue.operand_length;
 
-    for (auto &stmt_data : stmt_data_list)
+    if (dvalue.token != DATA_TOKEN_NONE && !header_changed)
         {
-            MsgPack stmt_data_object = stmt_data_to_msgpack_object (stmt_data);
-            gimple_json_list.push_back (stmt_data_object);
+            writer.value (int (dvalue.token));
+            return;
         }
 
-    for (auto &bb_data : basic_block_list)
+    writer.begin_map (header_changed ? 2 : 1);
+
+    if (header_changed)
+        {
+            last.code_class = dvalue.code_class;
+            last.code_name = dvalue.code_name;
+            last.is_expr = dvalue.is_expr;
+            last.operand_length = dvalue.operand_length;
+
+            writer.key ("h");
+            writer.begin_array (4);
+            writer.value (writer.intern (dvalue.code_class));
+            writer.value (writer.intern (dvalue.code_name));
+            writer.value (dvalue.is_expr);
+            writer.value (int (dvalue.operand_length));
+            writer.end_array ();
+        }
+
+    if (dvalue.token != DATA_TOKEN_NONE)
+        {
+            writer.key ("o");
+            writer.value (int (dvalue.token));
+            writer.end_map ();
+            return;
+        }
+
+    switch (dvalue.value_type)
+        {
+        case DATA_VALUE_SIMPLE:
+            writer.key ("v");
+            writer.value (dvalue.simple_data_value);
+            break;
+
+        case DATA_VALUE_COMPLEX:
+            {
+                // a nested list tracks its headers on its own, and the
+                // values after it compare against this value's header
+                data_writer::value_header outer = last;
+                last = data_writer::value_header ();
+
+                writer.key ("v");
+                write_data_value_list (writer, dvalue.complex_data_values);
+
+                last = outer;
+                break;
+            }
+
+        case DATA_VALUE_TYPE_REF:
+            writer.key ("t");
+            writer.value (dvalue.type_id);
+            break;
+        }
+
+    writer.end_map ();
+}
+
+/* Number of values DVALUES is written as, shared entries expanded.  */
+static size_t
+count_data_values (const extract_vector<data_value_t> &dvalues)
+{
+    size_t count = 0;
+    for (auto &dvalue : dvalues)
+        {
+            if (dvalue.shared_values)
+                count += count_data_values (*dvalue.shared_values);
+            else
+                count++;
+        }
+    return count;
+}
+
+static void
+write_data_value_items (data_writer &writer,
+                        const extract_vector<data_value_t> &dvalues)
+{
+    for (auto &dvalue : dvalues)
+        {
+            if (dvalue.shared_values)
+                write_data_value_items (writer, *dvalue.shared_values);
+            else if (writer.compact)
+                write_compact_data_value (writer, dvalue);
+            else
+                write_data_value (writer, dvalue);
+        }
+}
+
+/* A shared entry is written as the cached values it stands for, in line,
+   so the output does not depend on what was cached.  */
+static void
+write_data_value_list (data_writer &writer,
+                       const extract_vector<data_value_t> &dvalues)
+{
+    writer.begin_array (count_data_values (dvalues));
+    write_data_value_items (writer, dvalues);
+    writer.end_array ();
+}
+
+static void
+write_data_values (data_writer &writer, extract_vector<data_value_t> &dvalues)
+{
+    writer.last_header = data_writer::value_header ();
+    write_data_value_list (writer, dvalues);
+}
+
+void
+write_data_value (data_writer &writer, const data_value_t &dvalue)
+{
+    writer.begin_map (6);
+    writer.key ("code_class");
+    writer.value (dvalue.code_class);
+    writer.key ("code_name");
+    writer.value (dvalue.code_name);
+    writer.key ("is_expr");
+    writer.value (dvalue.is_expr);
+    writer.key ("operand_length");
+    writer.value (int (dvalue.operand_length));
+
+    switch (dvalue.value_type)
+        {
+        case DATA_VALUE_SIMPLE:
+            writer.key ("value");
+            writer.value (dvalue.simple_data_value);
+            break;
+
+        case DATA_VALUE_COMPLEX:
+            writer.key ("value");
+            write_data_value_list (writer, dvalue.complex_data_values);
+            break;
+
+        case DATA_VALUE_TYPE_REF:
+            writer.key ("type_id");
+            writer.value (dvalue.type_id);
+            break;
+        }
+
+    writer.key ("value_type");
+    writer.value (data_value_type_names[dvalue.value_type]);
+    writer.end_map ();
+}
+
+void
+write_tree_value (data_writer &writer, tree_value_t &tvalue)
+{
+    writer.begin_map (1);
+    writer.key ("values");
+    write_data_values (writer, tvalue.values);
+    writer.end_map ();
+}
+
+void
+write_tree_values (data_writer &writer, extract_vector<tree_value_t> &tvalues)
+{
+    writer.begin_array (tvalues.size ());
+    for (auto &tvalue : tvalues)
+        {
+            write_tree_value (writer, tvalue);
+        }
+    writer.end_array ();
+}
+
+static void
+write_optional_tree_value (data_writer &writer, bool has_value,
+                           tree_value_t &tvalue)
+{
+    if (has_value)
+        write_tree_value (writer, tvalue);
+    else
+        writer.empty_map ();
+}
+
+void
+write_stmt_data (data_writer &writer, gimple_stmt_data &stmt_data)
+{
+    writer.begin_map (10);
+
+    writer.key ("args");
+    write_stmt_data_args (writer, stmt_data);
+
+    writer.key ("basic_block_edges");
+    writer.value (stmt_data.basic_block_edges);
+    writer.key ("basic_block_index");
+    writer.value (stmt_data.basic_block_index);
+    writer.key ("gimple_code");
+    writer.value (stmt_data.gimple_stmt_code_str);
+    writer.key ("gimple_expr_code");
+    writer.value (stmt_data.gimple_stmt_expr_code_str);
+    writer.key ("gimple_num_ops");
+    writer.value (int (stmt_data.gimple_num_ops));
+    writer.key ("has_memory_operands");
+    writer.value (stmt_data.has_memory_operands);
+    writer.key ("has_register_or_memory_operands");
+    writer.value (stmt_data.has_register_or_memory_operands);
+    writer.key ("has_substatements");
+    writer.value (stmt_data.has_substatements);
+    writer.key ("lineno");
+    writer.value (stmt_data.lineno);
+
+    // { "function_name", stmt_data.function_name },
+    // { "filename", stmt_data.filename },
+    // { "vdef_value", stmt_data.vdef_value },
+    // { "vuse_value", stmt_data.vuse_value },
+
+    writer.end_map ();
+}
+
+void
+write_stmts_data (data_writer &writer, extract_vector<gimple_stmt_data> &stmts_data)
+{
+    writer.begin_array (stmts_data.size ());
+    for (auto &stmt_data : stmts_data)
+        {
+            write_stmt_data (writer, stmt_data);
+        }
+    writer.end_array ();
+}
+
+void
+write_stmt_data_args (data_writer &writer, gimple_stmt_data &stmt_data)
+{
+    switch (stmt_data.gimple_stmt_code)
+        {
+        case GIMPLE_ASM:
+            {
+                gimple_asm_data_t *asm_data
+                    = stmt_data.find<gimple_asm_data_t> ();
+                if (!asm_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (7);
+                writer.key ("gasm_clobber_operands");
+                write_tree_values (writer, asm_data->gasm_clobber_operands);
+                writer.key ("gasm_inline");
+                writer.value (asm_data->gasm_inline);
+                writer.key ("gasm_input_operands");
+                write_tree_values (writer, asm_data->gasm_input_operands);
+                writer.key ("gasm_labels");
+                write_tree_values (writer, asm_data->gasm_labels);
+                writer.key ("gasm_output_operands");
+                write_tree_values (writer, asm_data->gasm_output_operands);
+                writer.key ("gasm_string_code");
+                writer.value (asm_data->gasm_string_code);
+                writer.key ("gasm_volatile");
+                writer.value (asm_data->gasm_volatile);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_ASSIGN:
+            {
+                gimple_assign_data_t *assign_data
+                    = stmt_data.find<gimple_assign_data_t> ();
+                if (!assign_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (8);
+                writer.key ("gassign_has_rhs_arg1");
+                writer.value (assign_data->gassign_has_rhs_arg1);
+                writer.key ("gassign_has_rhs_arg2");
+                writer.value (assign_data->gassign_has_rhs_arg2);
+                writer.key ("gassign_has_rhs_arg3");
+                writer.value (assign_data->gassign_has_rhs_arg3);
+                writer.key ("gassign_lhs_arg");
+                write_tree_value (writer, assign_data->gassign_lhs_arg);
+                writer.key ("gassign_rhs_arg1");
+                write_optional_tree_value (writer,
+                                           assign_data->gassign_has_rhs_arg1,
+                                           assign_data->gassign_rhs_arg1);
+                writer.key ("gassign_rhs_arg2");
+                write_optional_tree_value (writer,
+                                           assign_data->gassign_has_rhs_arg2,
+                                           assign_data->gassign_rhs_arg2);
+                writer.key ("gassign_rhs_arg3");
+                write_optional_tree_value (writer,
+                                           assign_data->gassign_has_rhs_arg3,
+                                           assign_data->gassign_rhs_arg3);
+                writer.key ("gassign_subcode");
+                writer.value (assign_data->gassign_subcode);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_BIND:
+            {
+                gimple_bind_data_t *bind_data
+                    = stmt_data.find<gimple_bind_data_t> ();
+                if (!bind_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (1);
+                writer.key ("gbind_bind_vars");
+                write_tree_values (writer, bind_data->gbind_bind_vars);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_CALL:
+            {
+                gimple_call_data_t *call_data
+                    = stmt_data.find<gimple_call_data_t> ();
+                if (!call_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (14);
+                writer.key ("gcall_args");
+                write_tree_values (writer, call_data->gcall_args);
+                writer.key ("gcall_call_num_of_args");
+                writer.value (call_data->gcall_call_num_of_args);
+                writer.key ("gcall_fn");
+                write_tree_value (writer, call_data->gcall_fn);
+                writer.key ("gcall_has_lhs");
+                writer.value (call_data->gcall_has_lhs);
+                writer.key ("gcall_has_static_chain_for_call_statement");
+                writer.value (
+                    call_data->gcall_has_static_chain_for_call_statement);
+                writer.key ("gcall_internal_function_name");
+                writer.value (call_data->gcall_internal_function_name);
+                writer.key ("gcall_is_marked_as_a_tail_call");
+                writer.value (call_data->gcall_is_marked_as_a_tail_call);
+                writer.key (
+                    "gcall_is_marked_as_requiring_tail_call_optimization");
+                writer.value (
+                    call_data
+                        ->gcall_is_marked_as_requiring_tail_call_optimization);
+                writer.key ("gcall_is_marked_for_return_slot_optimization");
+                writer.value (
+                    call_data->gcall_is_marked_for_return_slot_optimization);
+                writer.key ("gcall_is_tm_clone");
+                writer.value (call_data->gcall_is_tm_clone);
+                writer.key ("gcall_isinternal_only_function");
+                writer.value (call_data->gcall_isinternal_only_function);
+                writer.key ("gcall_lhs_arg");
+                write_optional_tree_value (writer, call_data->gcall_has_lhs,
+                                           call_data->gcall_lhs_arg);
+                writer.key ("gcall_static_chain_for_call_statement");
+                write_optional_tree_value (
+                    writer,
+                    call_data->gcall_has_static_chain_for_call_statement,
+                    call_data->gcall_static_chain_for_call_statement);
+                writer.key ("gcall_transaction_code_properties");
+                writer.value (call_data->gcall_transaction_code_properties);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_COND:
+            {
+                gimple_cond_data_t *cond_data
+                    = stmt_data.find<gimple_cond_data_t> ();
+                if (!cond_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                int goto_true_edge = -1;
+                int else_goto_false_edge = -1;
+
+                if (cond_data->gcond_has_goto_true_edge)
+                    goto_true_edge = cond_data->goto_true_edge;
+
+                if (cond_data->gcond_has_else_goto_false_edge)
+                    else_goto_false_edge = cond_data->else_goto_false_edge;
+
+                writer.begin_map (11);
+                writer.key ("else_goto_false_edge");
+                writer.value (else_goto_false_edge);
+                writer.key ("gcond_false_else_goto_label");
+                write_optional_tree_value (
+                    writer, cond_data->gcond_has_false_else_goto_label,
+                    cond_data->gcond_false_else_goto_label);
+                writer.key ("gcond_has_else_goto_false_edge");
+                writer.value (cond_data->gcond_has_else_goto_false_edge);
+                writer.key ("gcond_has_false_else_goto_label");
+                writer.value (cond_data->gcond_has_false_else_goto_label);
+                writer.key ("gcond_has_goto_true_edge");
+                writer.value (cond_data->gcond_has_goto_true_edge);
+                writer.key ("gcond_has_true_goto_label");
+                writer.value (cond_data->gcond_has_true_goto_label);
+                writer.key ("gcond_lhs");
+                write_tree_value (writer, cond_data->gcond_lhs);
+                writer.key ("gcond_rhs");
+                write_tree_value (writer, cond_data->gcond_rhs);
+                writer.key ("gcond_tree_code_name");
+                writer.value (cond_data->gcond_tree_code_name);
+                writer.key ("gcond_true_goto_label");
+                write_optional_tree_value (writer,
+                                           cond_data->gcond_has_true_goto_label,
+                                           cond_data->gcond_true_goto_label);
+                writer.key ("goto_true_edge");
+                writer.value (goto_true_edge);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_LABEL:
+            {
+                gimple_label_data_t *label_data
+                    = stmt_data.find<gimple_label_data_t> ();
+                if (!label_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (2);
+                writer.key ("glabel_is_non_local");
+                writer.value (label_data->glabel_is_non_local);
+                writer.key ("glabel_label");
+                write_tree_value (writer, label_data->glabel_label);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_GOTO:
+            {
+                gimple_goto_data_t *goto_data
+                    = stmt_data.find<gimple_goto_data_t> ();
+                if (!goto_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (1);
+                writer.key ("ggoto_dest_goto_label");
+                write_tree_value (writer, goto_data->ggoto_dest_goto_label);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_NOP:
+            {
+                writer.begin_map (1);
+                writer.key ("gnop_nop_str");
+                writer.value ("GIMPLE_NOP");
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_RETURN:
+            {
+                gimple_return_data_t *return_data
+                    = stmt_data.find<gimple_return_data_t> ();
+                if (!return_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (2);
+                writer.key ("greturn_has_greturn_return_value");
+                writer.value (return_data->greturn_has_greturn_return_value);
+                writer.key ("greturn_return_value");
+                write_optional_tree_value (
+                    writer, return_data->greturn_has_greturn_return_value,
+                    return_data->greturn_return_value);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_SWITCH:
+            {
+                gimple_switch_data_t *switch_data
+                    = stmt_data.find<gimple_switch_data_t> ();
+                if (!switch_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (3);
+                writer.key ("gswitch_switch_case_labels");
+                write_tree_values (writer,
+                                   switch_data->gswitch_switch_case_labels);
+                writer.key ("gswitch_switch_index");
+                write_tree_value (writer, switch_data->gswitch_switch_index);
+                writer.key ("gswitch_switch_labels");
+                write_tree_values (writer, switch_data->gswitch_switch_labels);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_TRY:
+            {
+                gimple_try_data_t *try_data
+                    = stmt_data.find<gimple_try_data_t> ();
+                if (!try_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (4);
+                writer.key ("gtry_has_try_cleanup");
+                writer.value (try_data->gtry_has_try_cleanup);
+                writer.key ("gtry_try_cleanup");
+                if (try_data->gtry_has_try_cleanup)
+                    write_stmts_data (writer, try_data->gtry_try_cleanup);
+                else
+                    writer.empty_map ();
+                writer.key ("gtry_try_eval");
+                write_stmts_data (writer, try_data->gtry_try_eval);
+                writer.key ("gtry_try_type_kind");
+                writer.value (try_data->gtry_try_type_kind);
+                writer.end_map ();
+                break;
+            }
+
+        case GIMPLE_PHI:
+            {
+                gimple_phi_data_t *phi_data
+                    = stmt_data.find<gimple_phi_data_t> ();
+                if (!phi_data)
+                    {
+                        writer.empty_map ();
+                        break;
+                    }
+
+                writer.begin_map (4);
+                writer.key ("gphi_lhs");
+                write_tree_value (writer, phi_data->gphi_lhs);
+                writer.key ("gphi_phi_args");
+                write_tree_values (writer, phi_data->gphi_phi_args);
+                writer.key ("gphi_phi_args_basicblock_src_index");
+                writer.value (phi_data->gphi_phi_args_basicblock_src_index);
+                writer.key ("gphi_phi_args_locations");
+                writer.value (phi_data->gphi_phi_args_locations);
+                writer.end_map ();
+                break;
+            }
+
+        default:
+            writer.empty_map ();
+            break;
+        }
+}
+
+void
+write_gimple_phi_data (data_writer &writer, gimple_phi_t &phis_data)
+{
+    writer.begin_map (2);
+
+    writer.key ("gimple_phi_rhs_list");
+    writer.begin_array (phis_data.gimple_phi_rhs_list.size ());
+    for (auto &gimple_phi_rhs : phis_data.gimple_phi_rhs_list)
+        {
+            writer.begin_map (4);
+            writer.key ("basic_block_src_index");
+            writer.value (gimple_phi_rhs.basic_block_src_index);
+            writer.key ("column");
+            writer.value (gimple_phi_rhs.column);
+            writer.key ("line");
+            writer.value (gimple_phi_rhs.line);
+            writer.key ("phi_rhs");
+            write_tree_value (writer, gimple_phi_rhs.phi_rhs);
+            writer.end_map ();
+        }
+    writer.end_array ();
+
+    writer.key ("phi_lhs");
+    write_tree_value (writer, phis_data.phi_lhs);
+
+    writer.end_map ();
+}
+
+void
+write_bb_data (data_writer &writer, basicblock_t &bb_data)
+{
+    writer.begin_map (3);
+    writer.key ("bb_edges");
+    writer.value (bb_data.bb_edges);
+    writer.key ("bb_index");
+    writer.value (bb_data.bb_index);
+
+    writer.key ("phis");
+    writer.begin_array (bb_data.phis.size ());
+    for (auto &phis_data : bb_data.phis)
+        {
+            write_gimple_phi_data (writer, phis_data);
+        }
+    writer.end_array ();
+
+    writer.end_map ();
+}
+
+static void
+write_fn_arg_variable (data_writer &writer, fn_arg_variable_t &var)
+{
+    writer.begin_map (5);
+    writer.key ("arg");
+    write_tree_value (writer, var.arg);
+    writer.key ("var_declaration");
+    write_tree_value (writer, var.var_declaration);
+    writer.key ("var_def");
+    write_tree_value (writer, var.var_def);
+    writer.key ("var_ssa_name_var");
+    write_tree_value (writer, var.var_ssa_name_var);
+    writer.key ("var_type");
+    write_tree_value (writer, var.var_type);
+    writer.end_map ();
+}
+
+static void
+write_local_variable (data_writer &writer, fn_local_variable_t &var)
+{
+    writer.begin_map (2);
+    writer.key ("arg");
+    write_tree_value (writer, var.arg);
+    writer.key ("var_declaration");
+    write_tree_value (writer, var.var_declaration);
+    writer.end_map ();
+}
+
+static void
+write_fn_ssa_variable (data_writer &writer, fn_ssa_variable_t &var)
+{
+    writer.begin_map (2);
+    writer.key ("arg");
+    write_tree_value (writer, var.arg);
+    writer.key ("var_type");
+    write_tree_value (writer, var.var_type);
+    writer.end_map ();
+}
+
+void
+write_function_data (data_writer &writer, function_data_t &fn_data)
+{
+    bool has_type_table = !fn_data.fn_type_table.empty ();
+    writer.begin_map (has_type_table ? 11 : 10);
+
+    writer.key ("fn_args");
+    writer.begin_array (fn_data.fn_args.size ());
+    for (auto &var : fn_data.fn_args)
+        {
+            write_fn_arg_variable (writer, var);
+        }
+    writer.end_array ();
+
+    writer.key ("fn_decl");
+    write_tree_value (writer, fn_data.fn_decl);
+    writer.key ("fn_end_line_no");
+    writer.value (fn_data.fn_end_line_no);
+    writer.key ("fn_filename");
+    writer.value (fn_data.fn_filename);
+
+    writer.key ("fn_local_variables");
+    writer.begin_array (fn_data.fn_local_variables.size ());
+    for (auto &var : fn_data.fn_local_variables)
         {
-            MsgPack bb_data_object = bb_data_to_msgpack_object (bb_data);
-            basic_block_json_list.push_back (bb_data_object);
+            write_local_variable (writer, var);
         }
+    writer.end_array ();
 
-    MsgPack data = MsgPack::object {
-	    { "function_info", function_data_to_msgpack_object (fn_data) },
-        { "gimples", gimple_json_list },
-        { "basicblocks", basic_block_json_list },
-	};
-    return data.dump ();
-}
\ No newline at end of file
+    writer.key ("fn_name");
+    writer.value (fn_data.fn_name);
+    writer.key ("fn_source_lines");
+    writer.value (fn_data.fn_source_lines);
+    writer.key ("fn_ssa_names");
+    write_tree_values (writer, fn_data.fn_ssa_names);
+
+    writer.key ("fn_ssa_variables");
+    writer.begin_array (fn_data.fn_ssa_variables.size ());
+    for (auto &var : fn_data.fn_ssa_variables)
+        {
+            write_fn_ssa_variable (writer, var);
+        }
+    writer.end_array ();
+
+    writer.key ("fn_start_line_no");
+    writer.value (fn_data.fn_start_line_no);
+
+    if (has_type_table)
+        {
+            writer.key ("fn_type_table");
+            writer.value (fn_data.fn_type_table);
+        }
+
+    writer.end_map ();
+}
+
+void
+write_type_table (data_writer &writer, type_table_t &type_table)
+{
+    writer.begin_map (writer.compact ? 2 : 1);
+    writer.key ("types");
+    writer.begin_array (type_table.size ());
+    for (auto &entry : type_table)
+        {
+            writer.begin_map (2);
+            writer.key ("type_id");
+            writer.value (entry.first);
+            writer.key ("values");
+            write_data_values (writer, entry.second.values);
+            writer.end_map ();
+        }
+    writer.end_array ();
+
+    if (writer.compact)
+        {
+            writer.key ("strings");
+            writer.write_string_table ();
+        }
+
+    writer.end_map ();
+}
+
+void
+write_symbol_table (data_writer &writer, symbol_table_t &symbol_table)
+{
+    writer.begin_map (1);
+    writer.key ("symbols");
+    writer.begin_array (symbol_table.size ());
+    for (auto &symbol : symbol_table)
+        {
+            writer.begin_map (7);
+            writer.key ("asm_name");
+            writer.value (symbol.asm_name);
+            writer.key ("file");
+            writer.value (symbol.filename);
+            writer.key ("is_comdat");
+            writer.value (symbol.is_comdat);
+            writer.key ("is_public");
+            writer.value (symbol.is_public);
+            writer.key ("kind");
+            writer.value (symbol.kind);
+            writer.key ("line");
+            writer.value (symbol.line);
+            writer.key ("name");
+            writer.value (symbol.name);
+            writer.end_map ();
+        }
+    writer.end_array ();
+    writer.end_map ();
+}
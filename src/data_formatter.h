@@ -2,22 +2,41 @@
 #define H_DATA_FORMATTER_
 
 #include "gimple_extractor.h"
+#include "data_writer.h"
 #include <string>
 #include <vector>
 
 std::string
-function_to_string_dump (std::vector<gimple_stmt_data> &stmt_data_list,
-                         std::vector<basicblock_t> &basic_block_list,
-                         function_data_t &fn_data, std::string data_format);
+function_to_string_dump (extract_vector<gimple_stmt_data> &stmt_data_list,
+                         extract_vector<basicblock_t> &basic_block_list,
+                         function_data_t &fn_data, cfg_info_t &cfg_info,
+                         std::string data_format, std::string data_encoding);
 
-std::string
-function_to_string_dump_json (std::vector<gimple_stmt_data> &stmt_data_list,
-                              std::vector<basicblock_t> &basic_block_list,
-                              function_data_t &fn_data);
+std::string type_table_to_string_dump (type_table_t &type_table,
+                                       std::string data_format,
+                                       std::string data_encoding);
 
-std::string
-function_to_string_dump_msgpack (std::vector<gimple_stmt_data> &stmt_data_list,
-                                 std::vector<basicblock_t> &basic_block_list,
-                                 function_data_t &fn_data);
+std::string symbol_table_to_string_dump (symbol_table_t &symbol_table,
+                                         std::string data_format,
+                                         std::string data_encoding);
+
+void write_function (data_writer &writer,
+                     extract_vector<gimple_stmt_data> &stmt_data_list,
+                     extract_vector<basicblock_t> &basic_block_list,
+                     function_data_t &fn_data, cfg_info_t &cfg_info);
+void write_cfg_info (data_writer &writer, cfg_info_t &cfg_info);
+void write_function_data (data_writer &writer, function_data_t &fn_data);
+void write_stmts_data (data_writer &writer,
+                       extract_vector<gimple_stmt_data> &stmts_data);
+void write_stmt_data (data_writer &writer, gimple_stmt_data &stmt_data);
+void write_stmt_data_args (data_writer &writer, gimple_stmt_data &stmt_data);
+void write_tree_values (data_writer &writer,
+                        extract_vector<tree_value_t> &tvalues);
+void write_tree_value (data_writer &writer, tree_value_t &tvalue);
+void write_data_value (data_writer &writer, const data_value_t &dvalue);
+void write_gimple_phi_data (data_writer &writer, gimple_phi_t &phis_data);
+void write_bb_data (data_writer &writer, basicblock_t &bb_data);
+void write_type_table (data_writer &writer, type_table_t &type_table);
+void write_symbol_table (data_writer &writer, symbol_table_t &symbol_table);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,20 +1,35 @@
 #ifndef H_DATA_FORMATTER_MSGPACK_
 #define H_DATA_FORMATTER_MSGPACK_
 
-#include "ext/msgpack11.hpp"
-#include "gimple_extractor.h"
-using namespace msgpack11;
+#include "data_writer.h"
+#include <cstdint>
+#include <string>
 
 
-MsgPack function_data_to_msgpack_object(function_data_t &fn_data);
-MsgPack stmts_data_to_msgpack_object(std::vector<gimple_stmt_data> &stmts_data);
-MsgPack stmt_data_to_msgpack_object(gimple_stmt_data &stmt_data); 
-MsgPack tree_values_to_msgpack_object(std::vector<tree_value_t> &tvalues);
-MsgPack tree_value_to_msgpack_object(tree_value_t &tvalue);
-MsgPack data_value_to_msgpack_object(data_value_t &dvalue);
-MsgPack get_stmt_data_args_msgpack(gimple_stmt_data &stmt_data);
-MsgPack gimple_phi_data_to_msgpack_object(gimple_phi_t &phis_data);
-MsgPack bb_data_to_msgpack_object(basicblock_t &bb_data);
+class msgpack_data_writer : public data_writer
+{
+  public:
+    explicit msgpack_data_writer (std::string &out) : data_writer (out) {}
 
+    void begin_map (size_t size) override;
+    void end_map () override;
+    void begin_array (size_t size) override;
+    void end_array () override;
 
-#endif
\ No newline at end of file
+    void key (const char *key) override;
+    void value (const char *value, size_t size) override;
+    void value (int value) override;
+    void value (bool value) override;
+
+    using data_writer::value;
+
+  private:
+    void put (uint8_t byte);
+    void put_be16 (uint16_t value);
+    void put_be32 (uint32_t value);
+    void dump_container_header (size_t size, uint8_t fixed_tag, uint8_t tag16,
+                                uint8_t tag32);
+};
+
+
+#endif
@@ -0,0 +1,110 @@
+#include "data_pack.h"
+#include "output_file.h"
+#include <cstdio>
+
+static void
+pack_write_bytes (data_pack_t &pack, const char *data, size_t size)
+{
+    pack.file.write (data, size);
+    pack.offset += size;
+}
+
+static void
+pack_write_u32 (data_pack_t &pack, uint32_t value)
+{
+    char bytes[4];
+    for (int i = 0; i < 4; i++)
+        bytes[i] = (value >> (8 * i)) & 0xff;
+    pack_write_bytes (pack, bytes, sizeof (bytes));
+}
+
+static void
+pack_write_u64 (data_pack_t &pack, uint64_t value)
+{
+    char bytes[8];
+    for (int i = 0; i < 8; i++)
+        bytes[i] = (value >> (8 * i)) & 0xff;
+    pack_write_bytes (pack, bytes, sizeof (bytes));
+}
+
+static void
+pack_write_string (data_pack_t &pack, const std::string &value)
+{
+    pack_write_u32 (pack, value.size ());
+    pack_write_bytes (pack, value.data (), value.size ());
+}
+
+bool
+data_pack_open (data_pack_t &pack, const std::string &path,
+                const std::string &data_format)
+{
+    pack.path = path;
+    pack.temp_path = get_temp_output_path (path);
+    pack.offset = 0;
+    pack.entries.clear ();
+
+    pack.file.open (pack.temp_path,
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!pack.file.is_open ())
+        return false;
+
+    pack.is_open = true;
+
+    pack_write_bytes (pack, DATA_PACK_MAGIC, 4);
+    pack_write_u32 (pack, DATA_PACK_VERSION);
+    pack_write_string (pack, data_format);
+
+    return pack.file.good ();
+}
+
+bool
+data_pack_append (data_pack_t &pack, const std::string &name,
+                  const std::string &data)
+{
+    pack_write_string (pack, name);
+    pack_write_u64 (pack, data.size ());
+
+    data_pack_entry_t entry;
+    entry.name = name;
+    entry.offset = pack.offset;
+    entry.length = data.size ();
+    pack.entries.push_back (entry);
+
+    pack_write_bytes (pack, data.data (), data.size ());
+
+    return pack.file.good ();
+}
+
+bool
+data_pack_close (data_pack_t &pack)
+{
+    if (!pack.is_open)
+        return true;
+
+    uint64_t index_offset = pack.offset;
+
+    pack_write_u32 (pack, pack.entries.size ());
+    for (auto &entry : pack.entries)
+        {
+            pack_write_string (pack, entry.name);
+            pack_write_u64 (pack, entry.offset);
+            pack_write_u64 (pack, entry.length);
+        }
+
+    pack_write_u64 (pack, index_offset);
+    pack_write_bytes (pack, DATA_PACK_MAGIC, 4);
+
+    bool ok = pack.file.good ();
+    pack.file.close ();
+    pack.is_open = false;
+    pack.entries.clear ();
+
+    if (!ok || pack.file.fail ())
+        {
+            remove (pack.temp_path.c_str ());
+            return false;
+        }
+
+    std::string error;
+    return commit_output_file (pack.temp_path, pack.path, error);
+}
@@ -0,0 +1,53 @@
+#ifndef H_DATA_PACK_
+#define H_DATA_PACK_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Pack file: every function of a translation unit in a single file.
+ *
+ * All integers are little-endian.
+ *
+ *   header   "GXPK" | u32 version | u32 format_len | format
+ *   records  u32 name_len | name | u64 data_len | data        (repeated)
+ *   index    u32 count | (u32 name_len | name | u64 offset | u64 data_len)*
+ *   trailer  u64 index_offset | "GXPK"
+ *
+ * `offset` points at the first byte of the record's data, so a loader can
+ * either walk the records sequentially or seek to the trailer and use the
+ * index.
+ *
+ * The pack is written to a temporary file that replaces `path` when it is
+ * closed, so an interrupted compilation never leaves a truncated pack.
+ */
+
+#define DATA_PACK_MAGIC "GXPK"
+#define DATA_PACK_VERSION 1
+
+typedef struct _data_pack_entry
+{
+    std::string name;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+} data_pack_entry_t;
+
+typedef struct _data_pack
+{
+    std::string path;
+    std::string temp_path;
+    std::ofstream file;
+    bool is_open = false;
+    uint64_t offset = 0;
+    std::vector<data_pack_entry_t> entries;
+} data_pack_t;
+
+bool data_pack_open (data_pack_t &pack, const std::string &path,
+                     const std::string &data_format);
+bool data_pack_append (data_pack_t &pack, const std::string &name,
+                       const std::string &data);
+bool data_pack_close (data_pack_t &pack);
+
+#endif
@@ -36,6 +36,7 @@ std::string getEnvVar (std::string const &key);
 bool ends_with_char (const std::string &str, char c);
 bool starts_with_char (const std::string &str, char ch);
 
+// RELATIVE_PATH itself is returned when it cannot be resolved
 std::string
 get_full_path (const std::string &relative_path, bool throw_on_error)
 {
@@ -49,6 +50,7 @@ get_full_path (const std::string &relative_path, bool throw_on_error)
                     throw std::runtime_error (
                         "Error retrieving full path on Windows");
                 }
+            return relative_path;
         }
 #else
     if (realpath (relative_path.c_str (), full_path) == nullptr)
@@ -58,6 +60,7 @@ get_full_path (const std::string &relative_path, bool throw_on_error)
                     throw std::runtime_error (
                         "Error retrieving full path on POSIX");
                 }
+            return relative_path;
         }
 #endif
     return std::string (full_path);
@@ -0,0 +1,136 @@
+#ifndef H_DATA_WRITER_
+#define H_DATA_WRITER_
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Streaming serializer.
+ *
+ * The formatters walk the extracted data once and emit it through a
+ * data_writer, which encodes straight into a caller-owned buffer instead of
+ * building a Json/MsgPack tree first. Containers are sized up front because
+ * msgpack stores the element count in the container header. Map keys are
+ * emitted by the callers in sorted order, which keeps the output identical
+ * to the std::map backed json11/msgpack11 objects used previously.
+ */
+class data_writer
+{
+  public:
+    explicit data_writer (std::string &out) : out (out) {}
+    virtual ~data_writer () {}
+
+    virtual void begin_map (size_t size) = 0;
+    virtual void end_map () = 0;
+    virtual void begin_array (size_t size) = 0;
+    virtual void end_array () = 0;
+
+    virtual void key (const char *key) = 0;
+    virtual void value (const char *value, size_t size) = 0;
+    virtual void value (int value) = 0;
+    virtual void value (bool value) = 0;
+
+    void
+    value (const char *value)
+    {
+        this->value (value, strlen (value));
+    }
+
+    void
+    value (const std::string &value)
+    {
+        this->value (value.data (), value.size ());
+    }
+
+    template <typename Alloc>
+    void
+    value (const std::vector<int, Alloc> &values)
+    {
+        begin_array (values.size ());
+        for (int value : values)
+            this->value (value);
+        end_array ();
+    }
+
+    template <typename Alloc>
+    void
+    value (const std::vector<std::string, Alloc> &values)
+    {
+        begin_array (values.size ());
+        for (auto &value : values)
+            this->value (value);
+        end_array ();
+    }
+
+    void
+    value (const std::map<std::string, std::string> &values)
+    {
+        begin_map (values.size ());
+        for (auto &kv : values)
+            {
+                key (kv.first.c_str ());
+                value (kv.second);
+            }
+        end_map ();
+    }
+
+    void
+    empty_map ()
+    {
+        begin_map (0);
+        end_map ();
+    }
+
+    /* Compact encoding: strings passed to intern () are written as indexes
+       into a table that write_string_table () emits once per file.  Interned
+       strings are static (GCC's tree code tables), so they are keyed by
+       address.  */
+    bool compact = false;
+
+    int
+    intern (const char *str)
+    {
+        auto it = string_ids.find (str);
+        if (it != string_ids.end ())
+            return it->second;
+
+        int id = strings.size ();
+        string_ids[str] = id;
+        strings.push_back (str);
+        return id;
+    }
+
+    void
+    write_string_table ()
+    {
+        begin_array (strings.size ());
+        for (const char *str : strings)
+            value (str);
+        end_array ();
+    }
+
+    /* Compact encoding: header of the previous data value in the current
+       list, so a run of values from one tree node carries it only once.
+       Every list of values, nested ones included, starts from a reset
+       header.  */
+    struct value_header
+    {
+        const char *code_class = nullptr;
+        const char *code_name = nullptr;
+        bool is_expr = false;
+        unsigned int operand_length = 0;
+    } last_header;
+
+  protected:
+    std::string &out;
+
+  private:
+    std::unordered_map<const char *, int> string_ids;
+    std::vector<const char *> strings;
+};
+
+#endif
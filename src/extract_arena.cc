@@ -0,0 +1,141 @@
+#include "extract_arena.h"
+#include <cstdlib>
+#include <mutex>
+
+#define EXTRACT_ARENA_BLOCK_SIZE (64 * 1024)
+// larger blocks are given back on reset rather than kept for reuse
+#define EXTRACT_ARENA_KEEP_SIZE (4 * 1024 * 1024)
+#define EXTRACT_ARENA_ALIGN alignof (std::max_align_t)
+
+thread_local extract_arena *current_extract_arena = nullptr;
+
+static std::mutex arena_pool_mutex;
+static std::vector<extract_arena *> arena_pool;
+
+static size_t
+align_up (size_t size)
+{
+    return (size + EXTRACT_ARENA_ALIGN - 1) & ~(EXTRACT_ARENA_ALIGN - 1);
+}
+
+extract_arena::~extract_arena ()
+{
+    for (auto &block : blocks)
+        free (block.data);
+}
+
+void *
+extract_arena::allocate (size_t size)
+{
+    size = align_up (size);
+
+    if (blocks.empty () || blocks.back ().size - blocks.back ().used < size)
+        {
+            // blocks double in size so a large function needs few of them
+            size_t block_size = EXTRACT_ARENA_BLOCK_SIZE;
+            if (!blocks.empty ())
+                block_size = blocks.back ().size * 2;
+            while (block_size < size)
+                block_size *= 2;
+
+            extract_arena_block_t block;
+            block.data = static_cast<char *> (malloc (block_size));
+            if (!block.data)
+                throw std::bad_alloc ();
+            block.size = block_size;
+            block.used = 0;
+            blocks.push_back (block);
+        }
+
+    extract_arena_block_t &block = blocks.back ();
+    void *ptr = block.data + block.used;
+    block.used += size;
+    return ptr;
+}
+
+void
+extract_arena::deallocate (void *ptr, size_t size)
+{
+    // only the most recent allocation can be given back, which covers a
+    // vector growing by reallocation with nothing allocated in between
+    if (blocks.empty ())
+        return;
+
+    extract_arena_block_t &block = blocks.back ();
+    size = align_up (size);
+    if (static_cast<char *> (ptr) + size == block.data + block.used)
+        block.used -= size;
+}
+
+bool
+extract_arena::owns (const void *ptr) const
+{
+    const char *p = static_cast<const char *> (ptr);
+
+    // newest blocks are the largest and the most likely owners
+    for (auto it = blocks.rbegin (); it != blocks.rend (); ++it)
+        {
+            if (p >= it->data && p < it->data + it->size)
+                return true;
+        }
+
+    return false;
+}
+
+void
+extract_arena::reset ()
+{
+    if (blocks.empty ())
+        return;
+
+    extract_arena_block_t largest = blocks.back ();
+    blocks.pop_back ();
+
+    for (auto &block : blocks)
+        free (block.data);
+
+    blocks.clear ();
+
+    if (largest.size > EXTRACT_ARENA_KEEP_SIZE)
+        {
+            free (largest.data);
+            return;
+        }
+
+    largest.used = 0;
+    blocks.push_back (largest);
+}
+
+extract_arena *
+acquire_extract_arena ()
+{
+    {
+        std::lock_guard<std::mutex> lock (arena_pool_mutex);
+        if (!arena_pool.empty ())
+            {
+                extract_arena *arena = arena_pool.back ();
+                arena_pool.pop_back ();
+                return arena;
+            }
+    }
+
+    return new extract_arena ();
+}
+
+void
+release_extract_arena (extract_arena *arena)
+{
+    arena->reset ();
+
+    std::lock_guard<std::mutex> lock (arena_pool_mutex);
+    arena_pool.push_back (arena);
+}
+
+void
+clear_extract_arena_pool ()
+{
+    std::lock_guard<std::mutex> lock (arena_pool_mutex);
+    for (extract_arena *arena : arena_pool)
+        delete arena;
+    arena_pool.clear ();
+}
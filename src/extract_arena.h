@@ -0,0 +1,168 @@
+#ifndef H_EXTRACT_ARENA_
+#define H_EXTRACT_ARENA_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/*
+ * Per-function bump allocator.
+ *
+ * Everything extracted from a function lives until the function has been
+ * serialized and is then dropped at once, so the extraction containers
+ * allocate from an arena instead of the heap: allocation is a pointer bump
+ * and teardown releases whole blocks. An arena is installed on the current
+ * thread with an extract_arena_scope, both while a function is extracted
+ * and while it is serialized and destroyed (possibly on the writer
+ * thread); without one (or while suspended, e.g. for the unit-lifetime type
+ * table) allocations fall back to the heap.
+ *
+ * Containers must not outlive the arena that backs them, and an arena is
+ * only used by one thread at a time.
+ */
+
+typedef struct _extract_arena_block
+{
+    char *data;
+    size_t size;
+    size_t used;
+} extract_arena_block_t;
+
+class extract_arena
+{
+  public:
+    extract_arena () {}
+    ~extract_arena ();
+
+    extract_arena (const extract_arena &) = delete;
+    extract_arena &operator= (const extract_arena &) = delete;
+
+    void *allocate (size_t size);
+    void deallocate (void *ptr, size_t size);
+    bool owns (const void *ptr) const;
+
+    /* Drop every allocation but keep the largest block for reuse.  */
+    void reset ();
+
+    /* Number of active suspend () calls, allocations go to the heap
+       while non-zero.  */
+    int suspended = 0;
+
+  private:
+    std::vector<extract_arena_block_t> blocks;
+};
+
+/* Arena used by extract_allocator on this thread, null when allocating
+   from the heap.  */
+extern thread_local extract_arena *current_extract_arena;
+
+/* Reset arenas are pooled so that their largest block is reused by the
+   next function.  */
+extract_arena *acquire_extract_arena ();
+void release_extract_arena (extract_arena *arena);
+void clear_extract_arena_pool ();
+
+/* Install ARENA on the current thread for the lifetime of the scope, or
+   until close ().  */
+class extract_arena_scope
+{
+  public:
+    explicit extract_arena_scope (extract_arena *arena)
+        : previous (current_extract_arena)
+    {
+        current_extract_arena = arena;
+    }
+
+    ~extract_arena_scope () { close (); }
+
+    /* Restore the previous arena, e.g. before handing ARENA over to
+       another thread.  */
+    void
+    close ()
+    {
+        if (!is_open)
+            return;
+        current_extract_arena = previous;
+        is_open = false;
+    }
+
+  private:
+    extract_arena *previous;
+    bool is_open = true;
+};
+
+/* Allocate from the heap while alive, for data that outlives the function
+   being extracted.  */
+class extract_arena_suspend
+{
+  public:
+    extract_arena_suspend () : arena (current_extract_arena)
+    {
+        if (arena)
+            arena->suspended++;
+    }
+
+    ~extract_arena_suspend ()
+    {
+        if (arena)
+            arena->suspended--;
+    }
+
+  private:
+    extract_arena *arena;
+};
+
+/* Stateless so that containers can be moved and swapped freely; the
+   deallocation side checks which arena (if any) owns the pointer.  */
+template <typename T> class extract_allocator
+{
+  public:
+    typedef T value_type;
+
+    extract_allocator () {}
+    template <typename U> extract_allocator (const extract_allocator<U> &) {}
+
+    T *
+    allocate (size_t n)
+    {
+        extract_arena *arena = current_extract_arena;
+        if (arena && !arena->suspended)
+            return static_cast<T *> (arena->allocate (n * sizeof (T)));
+
+        return static_cast<T *> (::operator new (n * sizeof (T)));
+    }
+
+    void
+    deallocate (T *ptr, size_t n)
+    {
+        extract_arena *arena = current_extract_arena;
+        if (arena && arena->owns (ptr))
+            arena->deallocate (ptr, n * sizeof (T));
+        else
+            ::operator delete (ptr);
+    }
+
+    template <typename U> struct rebind
+    {
+        typedef extract_allocator<U> other;
+    };
+};
+
+template <typename T, typename U>
+bool
+operator== (const extract_allocator<T> &, const extract_allocator<U> &)
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool
+operator!= (const extract_allocator<T> &, const extract_allocator<U> &)
+{
+    return false;
+}
+
+template <typename T>
+using extract_vector = std::vector<T, extract_allocator<T> >;
+
+#endif
@@ -0,0 +1,160 @@
+#include "extract_filter.h"
+#include <fnmatch.h>
+#include <fstream>
+#include <regex>
+#include <vector>
+
+typedef struct _extract_filter_rule
+{
+    bool exclude = false;
+    bool match_file = false;
+    bool is_regex = false;
+    std::string pattern;
+    std::regex regex;
+} extract_filter_rule_t;
+
+static std::vector<extract_filter_rule_t> filter_rules;
+static bool has_include_rules = false;
+
+static bool
+strip_prefix (std::string &str, const char *prefix)
+{
+    size_t size = std::char_traits<char>::length (prefix);
+    if (str.compare (0, size, prefix) != 0)
+        return false;
+
+    str.erase (0, size);
+    return true;
+}
+
+static bool
+rule_matches (const extract_filter_rule_t &rule, const std::string &str)
+{
+    if (str.empty ())
+        return false;
+
+    if (rule.is_regex)
+        return std::regex_search (str, rule.regex);
+
+    return fnmatch (rule.pattern.c_str (), str.c_str (), 0) == 0;
+}
+
+bool
+extract_filter_add (bool exclude, const std::string &rule, std::string &error)
+{
+    extract_filter_rule_t filter_rule;
+    filter_rule.exclude = exclude;
+    filter_rule.pattern = rule;
+
+    if (strip_prefix (filter_rule.pattern, "file:"))
+        filter_rule.match_file = true;
+    else
+        strip_prefix (filter_rule.pattern, "name:");
+
+    if (strip_prefix (filter_rule.pattern, "re:"))
+        {
+            filter_rule.is_regex = true;
+            try
+                {
+                    filter_rule.regex = std::regex (filter_rule.pattern);
+                }
+            catch (const std::regex_error &e)
+                {
+                    error = "invalid regular expression '"
+                            + filter_rule.pattern + "': " + e.what ();
+                    return false;
+                }
+        }
+
+    if (filter_rule.pattern.empty ())
+        {
+            error = "empty pattern '" + rule + "'";
+            return false;
+        }
+
+    if (!exclude)
+        has_include_rules = true;
+
+    filter_rules.push_back (std::move (filter_rule));
+    return true;
+}
+
+bool
+extract_filter_load (const std::string &path, std::string &error)
+{
+    std::ifstream file (path);
+    if (!file.is_open ())
+        {
+            error = "unable to open filter file " + path;
+            return false;
+        }
+
+    std::string line;
+    int lineno = 0;
+    while (std::getline (file, line))
+        {
+            lineno++;
+
+            size_t start = line.find_first_not_of (" \t");
+            if (start == std::string::npos || line[start] == '#')
+                continue;
+
+            size_t end = line.find_last_not_of (" \t\r");
+            line = line.substr (start, end - start + 1);
+
+            size_t space = line.find_first_of (" \t");
+            std::string kind = line.substr (0, space);
+            std::string rule;
+            if (space != std::string::npos)
+                rule = line.substr (line.find_first_not_of (" \t", space));
+
+            std::string rule_error;
+            if ((kind != "include" && kind != "exclude")
+                || !extract_filter_add (kind == "exclude", rule, rule_error))
+                {
+                    error = path + ":" + std::to_string (lineno) + ": "
+                            + (rule_error.empty ()
+                                   ? "expected 'include RULE' or "
+                                     "'exclude RULE'"
+                                   : rule_error);
+                    return false;
+                }
+        }
+
+    return true;
+}
+
+bool
+extract_filter_is_empty ()
+{
+    return filter_rules.empty ();
+}
+
+bool
+extract_filter_match (const std::string &name, const std::string &mangled_name,
+                      const std::string &filename)
+{
+    bool included = !has_include_rules;
+
+    for (auto &rule : filter_rules)
+        {
+            // an excluded function stays excluded, an included one can
+            // still be excluded by a later rule
+            if (!rule.exclude && included)
+                continue;
+
+            bool matches = rule.match_file
+                               ? rule_matches (rule, filename)
+                               : (rule_matches (rule, name)
+                                  || rule_matches (rule, mangled_name));
+            if (!matches)
+                continue;
+
+            if (rule.exclude)
+                return false;
+
+            included = true;
+        }
+
+    return included;
+}
@@ -0,0 +1,35 @@
+#ifndef H_EXTRACT_FILTER_
+#define H_EXTRACT_FILTER_
+
+#include <string>
+
+/*
+ * Function include/exclude filters.
+ *
+ * A rule is a pattern, optionally prefixed with what it is matched
+ * against:
+ *
+ *   name:PATTERN   the function name, printable (demangled) or mangled
+ *   file:PATTERN   the full path of the function's source file
+ *   PATTERN        same as name:PATTERN
+ *
+ * PATTERN is a shell glob (fnmatch, `*` also matches `/`), or an ECMAScript
+ * regular expression searched anywhere in the string when it starts with
+ * `re:`. A function is extracted when no include rule was given or one of
+ * them matches, and no exclude rule matches.
+ *
+ * Filter files have one rule per line, `include RULE` or `exclude RULE`;
+ * empty lines and lines starting with `#` are ignored.
+ */
+
+/* False (with ERROR set) when RULE is not a valid pattern.  */
+bool extract_filter_add (bool exclude, const std::string &rule,
+                         std::string &error);
+bool extract_filter_load (const std::string &path, std::string &error);
+
+bool extract_filter_is_empty ();
+bool extract_filter_match (const std::string &name,
+                           const std::string &mangled_name,
+                           const std::string &filename);
+
+#endif
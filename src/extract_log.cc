@@ -0,0 +1,40 @@
+#include "extract_log.h"
+#include <cstdio>
+#include <mutex>
+
+#define EXTRACT_LOG_BUFFER_SIZE (64 * 1024)
+
+enum extract_log_level config_log_level = EXTRACT_LOG_SUMMARY;
+
+static std::mutex log_mutex;
+static std::string log_buffer;
+
+static void
+write_log_buffer ()
+{
+    fwrite (log_buffer.data (), 1, log_buffer.size (), stdout);
+    fflush (stdout);
+    log_buffer.clear ();
+}
+
+void
+extract_log (enum extract_log_level level, const std::string &message)
+{
+    if (!extract_log_enabled (level))
+        return;
+
+    std::lock_guard<std::mutex> lock (log_mutex);
+    log_buffer += message;
+    log_buffer += '\n';
+
+    if (log_buffer.size () >= EXTRACT_LOG_BUFFER_SIZE)
+        write_log_buffer ();
+}
+
+void
+extract_log_flush ()
+{
+    std::lock_guard<std::mutex> lock (log_mutex);
+    if (!log_buffer.empty ())
+        write_log_buffer ();
+}
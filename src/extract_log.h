@@ -0,0 +1,35 @@
+#ifndef H_EXTRACT_LOG_
+#define H_EXTRACT_LOG_
+
+#include <string>
+
+/*
+ * Progress log.
+ *
+ * Messages are collected in a buffer shared by the compiler thread and the
+ * writer pool and written to stdout in large chunks, instead of flushing
+ * every line. Errors are not logged here, they go straight to stderr.
+ */
+
+enum extract_log_level
+{
+    EXTRACT_LOG_QUIET,
+    // one line per translation unit
+    EXTRACT_LOG_SUMMARY,
+    // one line per function and step
+    EXTRACT_LOG_VERBOSE
+};
+
+extern enum extract_log_level config_log_level;
+
+inline bool
+extract_log_enabled (enum extract_log_level level)
+{
+    return level <= config_log_level;
+}
+
+/* Buffer MESSAGE (a newline is appended) if LEVEL is enabled.  */
+void extract_log (enum extract_log_level level, const std::string &message);
+void extract_log_flush ();
+
+#endif
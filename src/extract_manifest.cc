@@ -0,0 +1,105 @@
+#include "extract_manifest.h"
+#include "output_file.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <sys/stat.h>
+
+// the writer pool records finished outputs while the compiler claims new ones
+static std::mutex manifest_mutex;
+
+bool
+extract_manifest_open (extract_manifest_t &manifest, const std::string &path)
+{
+    manifest.path = path;
+    manifest.is_open = true;
+    manifest.previous.clear ();
+    manifest.seen.clear ();
+    manifest.current.clear ();
+
+    std::ifstream file (path);
+    if (!file.is_open ())
+        return false;
+
+    std::string line;
+    std::string magic;
+    int version = 0;
+    if (!std::getline (file, line))
+        return false;
+
+    std::istringstream header (line);
+    header >> magic >> version;
+    if (magic != EXTRACT_MANIFEST_MAGIC || version != EXTRACT_MANIFEST_VERSION)
+        return false;
+
+    while (std::getline (file, line))
+        {
+            size_t pos = line.find (' ');
+            if (pos == std::string::npos)
+                continue;
+
+            uint64_t fingerprint
+                = strtoull (line.substr (0, pos).c_str (), nullptr, 16);
+            manifest.previous[line.substr (pos + 1)] = fingerprint;
+        }
+
+    return true;
+}
+
+bool
+extract_manifest_claim (extract_manifest_t &manifest,
+                        const std::string &output_path)
+{
+    return manifest.seen.insert (output_path).second;
+}
+
+bool
+extract_manifest_is_unchanged (const extract_manifest_t &manifest,
+                               const std::string &output_path,
+                               uint64_t fingerprint)
+{
+    auto it = manifest.previous.find (output_path);
+    if (it == manifest.previous.end () || it->second != fingerprint)
+        return false;
+
+    // the output may have been removed since
+    struct stat info;
+    return stat (output_path.c_str (), &info) == 0;
+}
+
+void
+extract_manifest_record (extract_manifest_t &manifest,
+                         const std::string &output_path, uint64_t fingerprint)
+{
+    std::lock_guard<std::mutex> lock (manifest_mutex);
+    manifest.current[output_path] = fingerprint;
+}
+
+bool
+extract_manifest_close (extract_manifest_t &manifest)
+{
+    if (!manifest.is_open)
+        return true;
+
+    manifest.is_open = false;
+    manifest.previous.clear ();
+    manifest.seen.clear ();
+
+    std::lock_guard<std::mutex> lock (manifest_mutex);
+
+    std::ostringstream file;
+    file << EXTRACT_MANIFEST_MAGIC << " " << EXTRACT_MANIFEST_VERSION << "\n";
+    for (auto &entry : manifest.current)
+        {
+            char hex[17];
+            snprintf (hex, sizeof (hex), "%016llx",
+                      static_cast<unsigned long long> (entry.second));
+            file << hex << " " << entry.first << "\n";
+        }
+    manifest.current.clear ();
+
+    std::string error;
+    return write_output_file (manifest.path, file.str (), error);
+}
@@ -0,0 +1,93 @@
+#ifndef H_EXTRACT_MANIFEST_
+#define H_EXTRACT_MANIFEST_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/*
+ * Incremental extraction manifest.
+ *
+ * Every translation unit keeps a manifest next to its output listing the
+ * fingerprint of each function written for it:
+ *
+ *   GXMF 1
+ *   <fingerprint, 16 hex digits> <output path>        (one per function)
+ *
+ * A function whose fingerprint matches the previous manifest (and whose
+ * output still exists) is not extracted again. The manifest is rewritten
+ * when the unit is finished, with skipped functions carried over.
+ */
+
+#define EXTRACT_MANIFEST_MAGIC "GXMF"
+#define EXTRACT_MANIFEST_VERSION 1
+
+#define FINGERPRINT_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FINGERPRINT_PRIME 0x100000001b3ULL
+
+/* 64-bit FNV-1a, stable across runs and hosts.  */
+typedef struct _fingerprint
+{
+    uint64_t hash = FINGERPRINT_OFFSET_BASIS;
+} fingerprint_t;
+
+inline void
+fingerprint_add (fingerprint_t &fp, const char *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        {
+            fp.hash ^= static_cast<unsigned char> (data[i]);
+            fp.hash *= FINGERPRINT_PRIME;
+        }
+}
+
+/* Strings are length-prefixed so that "ab" + "c" differs from "a" + "bc".  */
+inline void
+fingerprint_add (fingerprint_t &fp, const std::string &str)
+{
+    uint64_t size = str.size ();
+    fingerprint_add (fp, reinterpret_cast<const char *> (&size), sizeof (size));
+    fingerprint_add (fp, str.data (), str.size ());
+}
+
+inline void
+fingerprint_add (fingerprint_t &fp, int64_t value)
+{
+    fingerprint_add (fp, reinterpret_cast<const char *> (&value),
+                     sizeof (value));
+}
+
+typedef struct _extract_manifest
+{
+    std::string path;
+    bool is_open = false;
+
+    // fingerprints found in the manifest on disk
+    std::unordered_map<std::string, uint64_t> previous;
+
+    // output paths seen in this unit, only used by the compiler thread
+    std::unordered_set<std::string> seen;
+
+    // fingerprints of this unit's outputs, guarded by a lock in the .cc file
+    std::map<std::string, uint64_t> current;
+} extract_manifest_t;
+
+bool extract_manifest_open (extract_manifest_t &manifest,
+                            const std::string &path);
+
+/* False when OUTPUT_PATH was already claimed in this unit (e.g. overloads
+   written to the same file), such outputs are never skipped.  */
+bool extract_manifest_claim (extract_manifest_t &manifest,
+                             const std::string &output_path);
+bool extract_manifest_is_unchanged (const extract_manifest_t &manifest,
+                                    const std::string &output_path,
+                                    uint64_t fingerprint);
+void extract_manifest_record (extract_manifest_t &manifest,
+                              const std::string &output_path,
+                              uint64_t fingerprint);
+bool extract_manifest_close (extract_manifest_t &manifest);
+
+#endif
@@ -0,0 +1,226 @@
+#include "extract_stats.h"
+#include "output_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#define EXTRACT_STATS_TOP_FUNCTIONS 10
+
+bool extract_stats_enabled = false;
+
+static std::mutex stats_mutex;
+
+static const char *const extract_phase_names[] = {
+    "source", "fingerprint", "decl", "args",      "locals",
+    "ssa",    "stmts",       "cfg",  "serialize", "write",
+};
+
+static uint64_t
+phase_total_ns (const uint64_t *phase_ns)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < EXTRACT_PHASE_COUNT; i++)
+        total += phase_ns[i];
+    return total;
+}
+
+static void
+write_json_string (std::ostream &out, const std::string &str)
+{
+    out << '"';
+    for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if (static_cast<unsigned char> (c) < 0x20)
+                {
+                    char escaped[7];
+                    snprintf (escaped, sizeof (escaped), "\\u%04x", c);
+                    out << escaped;
+                }
+            else
+                out << c;
+        }
+    out << '"';
+}
+
+static void
+write_json_seconds (std::ostream &out, uint64_t ns)
+{
+    char seconds[32];
+    snprintf (seconds, sizeof (seconds), "%.6f", ns / 1e9);
+    out << seconds;
+}
+
+static void
+write_json_phases (std::ostream &out, const uint64_t *phase_ns)
+{
+    out << "{";
+    for (int i = 0; i < EXTRACT_PHASE_COUNT; i++)
+        {
+            if (i > 0)
+                out << ", ";
+            write_json_string (out, extract_phase_names[i]);
+            out << ": ";
+            write_json_seconds (out, phase_ns[i]);
+        }
+    out << "}";
+}
+
+uint64_t
+extract_stats_clock ()
+{
+    if (!extract_stats_enabled)
+        return 0;
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+               std::chrono::steady_clock::now ().time_since_epoch ())
+        .count ();
+}
+
+void
+extract_stats_lap (function_stats_t &stats, enum extract_phase phase,
+                   uint64_t &clock)
+{
+    if (!extract_stats_enabled)
+        return;
+
+    uint64_t now = extract_stats_clock ();
+    stats.phase_ns[phase] += now - clock;
+    clock = now;
+}
+
+void
+extract_stats_add_function (extract_stats_t &unit_stats,
+                            const function_stats_t &stats)
+{
+    if (!extract_stats_enabled)
+        return;
+
+    std::lock_guard<std::mutex> lock (stats_mutex);
+    for (int i = 0; i < EXTRACT_PHASE_COUNT; i++)
+        unit_stats.phase_ns[i] += stats.phase_ns[i];
+    unit_stats.output_size += stats.output_size;
+    unit_stats.functions.push_back (stats);
+}
+
+void
+extract_stats_add_skipped (extract_stats_t &unit_stats,
+                           const function_stats_t &stats)
+{
+    if (!extract_stats_enabled)
+        return;
+
+    std::lock_guard<std::mutex> lock (stats_mutex);
+    for (int i = 0; i < EXTRACT_PHASE_COUNT; i++)
+        unit_stats.phase_ns[i] += stats.phase_ns[i];
+    unit_stats.skipped_count++;
+}
+
+bool
+extract_stats_write (const extract_stats_t &unit_stats,
+                     const std::string &path)
+{
+    std::ostringstream file;
+    file << "{\"unit\": ";
+    write_json_string (file, unit_stats.unit);
+    file << ", \"functions_extracted\": " << unit_stats.functions.size ()
+         << ", \"functions_skipped\": " << unit_stats.skipped_count
+         << ", \"output_bytes\": " << unit_stats.output_size
+         << ", \"total\": ";
+    write_json_seconds (file, phase_total_ns (unit_stats.phase_ns));
+    file << ", \"phases\": ";
+    write_json_phases (file, unit_stats.phase_ns);
+    file << ",\n \"functions\": [";
+
+    for (size_t i = 0; i < unit_stats.functions.size (); i++)
+        {
+            const function_stats_t &stats = unit_stats.functions[i];
+
+            file << (i > 0 ? ",\n  " : "\n  ") << "{\"name\": ";
+            write_json_string (file, stats.name);
+            file << ", \"file\": ";
+            write_json_string (file, stats.filename);
+            file << ", \"stage\": ";
+            write_json_string (file, stats.stage);
+            file << ", \"stmts\": " << stats.stmt_count
+                 << ", \"output_bytes\": " << stats.output_size
+                 << ", \"total\": ";
+            write_json_seconds (file, phase_total_ns (stats.phase_ns));
+            file << ", \"phases\": ";
+            write_json_phases (file, stats.phase_ns);
+            file << "}";
+        }
+    file << "]}\n";
+
+    std::string error;
+    return write_output_file (path, file.str (), error);
+}
+
+std::string
+extract_stats_summary (const extract_stats_t &unit_stats)
+{
+    std::ostringstream summary;
+
+    summary << "[gimple-extractor] " << unit_stats.unit << ": "
+            << unit_stats.functions.size () << " functions extracted, "
+            << unit_stats.skipped_count << " skipped, "
+            << unit_stats.output_size << " bytes written, " << std::fixed
+            << std::setprecision (3)
+            << phase_total_ns (unit_stats.phase_ns) / 1e9 << "s";
+
+    return summary.str ();
+}
+
+void
+extract_stats_print (const extract_stats_t &unit_stats, std::ostream &out)
+{
+    out << extract_stats_summary (unit_stats) << "\n" << std::fixed
+        << std::setprecision (3);
+
+    for (int i = 0; i < EXTRACT_PHASE_COUNT; i++)
+        {
+            out << "  " << std::left << std::setw (12)
+                << extract_phase_names[i] << std::right << std::setw (10)
+                << unit_stats.phase_ns[i] / 1e9 << "s\n";
+        }
+
+    std::vector<const function_stats_t *> slowest;
+    for (auto &stats : unit_stats.functions)
+        slowest.push_back (&stats);
+
+    size_t count = std::min (slowest.size (),
+                             static_cast<size_t> (EXTRACT_STATS_TOP_FUNCTIONS));
+    std::partial_sort (slowest.begin (), slowest.begin () + count,
+                       slowest.end (),
+                       [] (const function_stats_t *a,
+                           const function_stats_t *b) {
+                           return phase_total_ns (a->phase_ns)
+                                  > phase_total_ns (b->phase_ns);
+                       });
+
+    for (size_t i = 0; i < count; i++)
+        {
+            out << "  " << std::setw (10)
+                << phase_total_ns (slowest[i]->phase_ns) / 1e9 << "s  "
+                << slowest[i]->name << " (" << slowest[i]->stmt_count
+                << " stmts)\n";
+        }
+
+    out << std::defaultfloat;
+}
+
+void
+extract_stats_clear (extract_stats_t &unit_stats)
+{
+    std::lock_guard<std::mutex> lock (stats_mutex);
+    unit_stats.unit.clear ();
+    unit_stats.skipped_count = 0;
+    unit_stats.output_size = 0;
+    std::fill (unit_stats.phase_ns, unit_stats.phase_ns + EXTRACT_PHASE_COUNT,
+               0);
+    unit_stats.functions.clear ();
+}
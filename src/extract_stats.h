@@ -0,0 +1,87 @@
+#ifndef H_EXTRACT_STATS_
+#define H_EXTRACT_STATS_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * Extraction timers.
+ *
+ * Every extracted function carries a function_stats_t whose phases are
+ * timed with laps of a monotonic clock:
+ *
+ *   uint64_t clock = extract_stats_clock ();
+ *   ...read the source lines...
+ *   extract_stats_lap (stats, EXTRACT_PHASE_SOURCE, clock);
+ *
+ * Finished functions are added to the unit's extract_stats_t, which is
+ * written as JSON when the unit is finished. Timing is off (and the calls
+ * are no-ops) unless extract_stats_enabled is set.
+ */
+
+enum extract_phase
+{
+    EXTRACT_PHASE_SOURCE,
+    EXTRACT_PHASE_FINGERPRINT,
+    EXTRACT_PHASE_DECL,
+    EXTRACT_PHASE_ARGS,
+    EXTRACT_PHASE_LOCALS,
+    EXTRACT_PHASE_SSA,
+    EXTRACT_PHASE_STMTS,
+    EXTRACT_PHASE_CFG,
+    EXTRACT_PHASE_SERIALIZE,
+    EXTRACT_PHASE_WRITE,
+    EXTRACT_PHASE_COUNT
+};
+
+typedef struct _function_stats
+{
+    std::string name;
+    std::string filename;
+    // empty when functions are extracted after a single pass
+    std::string stage;
+    size_t stmt_count = 0;
+    size_t output_size = 0;
+    uint64_t phase_ns[EXTRACT_PHASE_COUNT] = {};
+} function_stats_t;
+
+typedef struct _extract_stats
+{
+    std::string unit;
+    size_t skipped_count = 0;
+    uint64_t output_size = 0;
+    uint64_t phase_ns[EXTRACT_PHASE_COUNT] = {};
+    std::vector<function_stats_t> functions;
+} extract_stats_t;
+
+extern bool extract_stats_enabled;
+
+uint64_t extract_stats_clock ();
+
+/* Add the time since CLOCK to PHASE and restart CLOCK.  */
+void extract_stats_lap (function_stats_t &stats, enum extract_phase phase,
+                        uint64_t &clock);
+
+/* Safe to call from the writer pool.  */
+void extract_stats_add_function (extract_stats_t &unit_stats,
+                                 const function_stats_t &stats);
+
+/* Only the phases of a skipped function are added to the unit totals.  */
+void extract_stats_add_skipped (extract_stats_t &unit_stats,
+                                const function_stats_t &stats);
+
+bool extract_stats_write (const extract_stats_t &unit_stats,
+                          const std::string &path);
+
+/* One line: functions extracted and skipped, bytes written and time.  */
+std::string extract_stats_summary (const extract_stats_t &unit_stats);
+
+/* Human readable report: phase totals and the slowest functions.  */
+void extract_stats_print (const extract_stats_t &unit_stats, std::ostream &out);
+
+void extract_stats_clear (extract_stats_t &unit_stats);
+
+#endif
@@ -11,7 +11,21 @@
 #include "gimple_extractor.h"
 #include "data_formatter.h"
 #include "data_utils.h"
+#include "source_cache.h"
+#include "source_paths.h"
+#include "output_dirs.h"
+#include "output_file.h"
+#include "data_pack.h"
+#include "extract_manifest.h"
+#include "extract_stats.h"
+#include "extract_log.h"
+#include "extract_filter.h"
+#include "call_graph.h"
+#include "async_writer.h"
 #include "cgraph.h"
+#include "flags.h"
+#include "dominance.h"
+#include "cfgloop.h"
 
 
 // We must assert that this plugin is GPL compatible
@@ -19,7 +33,107 @@ int plugin_is_GPL_compatible;
 
 std::string config_data_format = "msgpack";
 std::string config_output_path = "__default_gimple_extract_output/";
-std::string config_source_path = ".";
+std::string config_output_mode = "file";
+std::string config_output_naming = "name";
+// passes after which functions are extracted, see get_stage_dir ()
+std::vector<std::string> config_passes = { "ssa" };
+std::string config_data_encoding = "default";
+bool config_type_table = false;
+bool config_async_write = false;
+int config_jobs = 1;
+bool config_incremental = false;
+bool config_stats = false;
+// COMDAT functions are only extracted by the first unit to claim them
+bool config_dedup = false;
+bool config_call_graph = false;
+bool config_cfg_info = false;
+// extract in the link-time compilation instead of every unit, see
+// is_extracting_compilation ()
+bool config_lto = false;
+std::string config_lto_name = "program";
+
+// all functions of the unit when config_output_mode is "pack", of the
+// process when it is "shard"
+static data_pack_t unit_data_pack;
+
+// types referenced by the unit, keyed by TYPE_UID, when config_type_table
+static type_table_t unit_type_table;
+
+// fingerprints of the unit's function outputs, when config_incremental
+static extract_manifest_t unit_manifest;
+
+// plugin, GCC and options behind every output, see get_output_fingerprint ()
+static fingerprint_t output_fingerprint_salt;
+
+// symbols defined by the unit, when config_lto
+static symbol_table_t unit_symbol_table;
+
+// calls made by the unit's functions, when config_call_graph
+static call_graph_t unit_call_graph;
+
+// phase timings of the unit's functions, when extract_stats_enabled
+static extract_stats_t unit_stats;
+
+/* A function extracted by execute (), serialized by run () and written by
+   commit (), either right away or on the async writer pool.  The job owns
+   the arena backing its data and installs it wherever the data is used or
+   freed.  */
+typedef struct _function_extract
+{
+    function_data_t fn_data;
+    extract_vector<gimple_stmt_data> stmt_data_list;
+    extract_vector<basicblock_t> basic_block_list;
+    cfg_info_t cfg_info;
+
+    // cached tree descriptions the values above refer to
+    tree_values_cache_t shared_tree_values;
+} function_extract_t;
+
+class function_write_job : public async_job
+{
+  public:
+    function_write_job ()
+        : arena (acquire_extract_arena ()), data (new function_extract_t)
+    {
+    }
+
+    ~function_write_job ()
+    {
+        // the job failed or was dropped before its output was written
+        if (!claim_path.empty () && !output_written)
+            release_output_claim (claim_path);
+
+        {
+            extract_arena_scope arena_scope (arena);
+            data.reset ();
+        }
+        release_extract_arena (arena);
+    }
+
+    void run () override;
+    void commit () override;
+
+    extract_arena *arena;
+    std::unique_ptr<function_extract_t> data;
+    std::string fn_extract_dump;
+
+    // file or pack record name, see get_function_output_name ()
+    std::string output_name;
+    std::string stage_dir;
+
+    // recorded in the unit manifest once written, when config_incremental;
+    // the fingerprint of the serialized output, unless is_fingerprinted is
+    // false (another function of the unit has the same output)
+    std::string output_path;
+    bool is_fingerprinted = false;
+    uint64_t fingerprint = 0;
+
+    // output claimed for dedup, see claim_output_file ()
+    std::string claim_path;
+    bool output_written = false;
+
+    function_stats_t stats;
+};
 
 
 static struct plugin_info my_gcc_plugin_info = {
@@ -27,13 +141,25 @@ static struct plugin_info my_gcc_plugin_info = {
     "This is a gimple extractor plugin to extract gimple instructions" 
 };
 
+/* With lto=yes the compile step only streams the bodies out, they are
+   extracted once by the link-time compilation that generates code for
+   them (LTRANS, or lto1 itself with -flto-partition=none), after the
+   symbol table has merged the copies of every unit.  */
+static bool
+is_extracting_compilation ()
+{
+    if (config_lto)
+        return in_lto_p && !flag_wpa;
+    return true;
+}
+
 namespace
 {
 const pass_data gimple_extractor_pass_data = {
     GIMPLE_PASS,
     "gimple_extractor_pass", /* name */
     OPTGROUP_NONE,         /* optinfo_flags */
-    TV_NONE,               /* tv_id */
+    TV_PLUGIN_RUN,         /* tv_id */
     PROP_gimple_any,       /* properties_required */
     0,                     /* properties_provided */
     0,                     /* properties_destroyed */
@@ -43,20 +169,35 @@ const pass_data gimple_extractor_pass_data = {
 
 struct gimple_extractor_pass : gimple_opt_pass
 {
-    gimple_extractor_pass (gcc::context *ctx)
-        : gimple_opt_pass (gimple_extractor_pass_data, ctx)
+    gimple_extractor_pass (gcc::context *ctx, std::string stage)
+        : gimple_opt_pass (gimple_extractor_pass_data, ctx),
+          stage_dir (get_stage_dir (stage))
     {
     }
 
+    // output subdirectory of the pass this instance runs after
+    std::string stage_dir;
+
+    virtual bool
+    gate (function *) override
+    {
+        return is_extracting_compilation ();
+    }
+
     virtual unsigned int
     execute (function *fun) override
     {
         // function *fun
         // `struct GTY(()) function` defined in gcc-10.1.0/gcc/function.h
 
-        function_data_t fn_data;
+        std::unique_ptr<function_write_job> job (new function_write_job);
+        extract_arena_scope arena_scope (job->arena);
+
+        function_data_t &fn_data = job->data->fn_data;
         fn_data.fn_name = function_name (fun);
 
+        clear_tree_data_values_cache ();
+
         {
             expanded_location xloc
                 = expand_location (fun->function_start_locus);
@@ -80,17 +221,33 @@ struct gimple_extractor_pass : gimple_opt_pass
         if (fn_data.fn_filename.size () == 0)
             return 0;
 
-        fn_data.fn_filename = get_full_path(fn_data.fn_filename, true);
+        std::string full_path;
+        if (!get_canonical_path (fn_data.fn_filename, full_path))
+            return 0;
+        fn_data.fn_filename = full_path;
 
-        if (!starts_with(fn_data.fn_filename, config_source_path)) 
+        // nothing is extracted without a source_path
+        if (!find_source_root (fn_data.fn_filename))
             return 0;
 
-        std::cout << "[gimple-extractor] processing ... [" << fn_data.fn_filename << "] -- "
-                  << fn_data.fn_name << std::endl;
+        if (!extract_filter_is_empty ()
+            && !extract_filter_match (
+                fn_data.fn_name,
+                IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (fun->decl)),
+                fn_data.fn_filename))
+            return 0;
 
-        std::vector<std::string> source_lines
-            = readFileToVector (std::string (fn_data.fn_filename));
-        int source_lines_size = source_lines.size ();
+        if (extract_log_enabled (EXTRACT_LOG_VERBOSE))
+            extract_log (EXTRACT_LOG_VERBOSE,
+                         "[gimple-extractor] processing ... ["
+                             + fn_data.fn_filename + "] -- " + fn_data.fn_name);
+
+        function_stats_t &stats = job->stats;
+        uint64_t clock = extract_stats_clock ();
+
+        const source_file_t *source_file
+            = get_source_file (fn_data.fn_filename);
+        int source_lines_size = get_source_line_count (source_file);
 
         std::vector<int> start_end_range
             = getRangeVector (fn_data.fn_start_line_no, fn_data.fn_end_line_no);
@@ -104,31 +261,93 @@ struct gimple_extractor_pass : gimple_opt_pass
                     }
                 else
                     {
-                        int real_lineno = num - 1;
-                        if (real_lineno < source_lines_size)
-                            {
-                                fn_data.fn_source_lines[std::to_string (num)]
-                                    = source_lines.at (real_lineno);
-                            }
-                        else
-                            {
-                                fn_data.fn_source_lines[std::to_string (num)]
-                                    = "";
-                            }
+                        fn_data.fn_source_lines[std::to_string (num)]
+                            = get_source_line (source_file, num);
                     }
             }
 
+        extract_stats_lap (stats, EXTRACT_PHASE_SOURCE, clock);
+
+        job->output_name = get_function_output_name (fun, fn_data);
+        job->stage_dir = stage_dir;
+
+        if (config_incremental)
+            {
+                job->output_path = get_function_output_path (
+                    fn_data.fn_filename, job->output_name, stage_dir);
+
+                if (!unit_manifest.is_open)
+                    extract_manifest_open (unit_manifest,
+                                           get_unit_manifest_path ());
+
+                // a second function with the same output is always written
+                // and leaves a fingerprint that never matches; the others
+                // are compared once serialized, see function_write_job::run
+                job->is_fingerprinted
+                    = extract_manifest_claim (unit_manifest, job->output_path);
+            }
+
+        // inline functions and template instances are emitted by every
+        // unit that uses them, the first compilation to claim one extracts
+        // it for all of them
+        if (config_dedup
+            && (DECL_COMDAT (fun->decl) || DECL_ONE_ONLY (fun->decl)))
+            {
+                uint64_t body_fingerprint
+                    = get_function_fingerprint (fun, fn_data);
+                extract_stats_lap (stats, EXTRACT_PHASE_FINGERPRINT, clock);
+
+                std::string output_path = get_function_output_path (
+                    fn_data.fn_filename, job->output_name, stage_dir);
+                std::string output_dir_path
+                    = output_path.substr (0, output_path.find_last_of ('/'));
+
+                char key[17];
+                snprintf (key, sizeof (key), "%016llx",
+                          (unsigned long long)body_fingerprint);
+
+                enum output_claim claim = OUTPUT_CLAIM_ERROR;
+                std::string error = "error creating directory "
+                                    + output_dir_path;
+                if (create_output_directories (output_dir_path))
+                    claim = claim_output_file (
+                        output_path, get_unit_filename (), key, error);
+
+                if (claim == OUTPUT_CLAIM_ERROR)
+                    std::cerr << "[gimple-extractor] " << error
+                              << ", not extracting " << fn_data.fn_name
+                              << std::endl;
+
+                if (claim != OUTPUT_CLAIM_TAKEN)
+                    {
+                        extract_stats_add_skipped (unit_stats, stats);
+
+                        if (claim == OUTPUT_CLAIM_HELD
+                            && extract_log_enabled (EXTRACT_LOG_VERBOSE))
+                            extract_log (EXTRACT_LOG_VERBOSE,
+                                         "[gimple-extractor] duplicate ... ["
+                                             + fn_data.fn_filename + "] -- "
+                                             + fn_data.fn_name);
+                        return 0;
+                    }
+
+                // released by the job unless the output gets written
+                job->claim_path = output_path;
+            }
+
         // function tree data
         {
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (fun->decl, dvalues);
 
-            tvalue.values = dvalues;
-            fn_data.fn_decl = tvalue;
+            tvalue.values = std::move (dvalues);
+            fn_data.fn_decl = std::move (tvalue);
         }
 
+        extract_stats_lap (stats, EXTRACT_PHASE_DECL, clock);
+
         // function args tree data
         if (DECL_ARGUMENTS (fun->decl))
             {
@@ -143,61 +362,63 @@ struct gimple_extractor_pass : gimple_opt_pass
                             {
                                 {
                                     tree_value_t tvalue;
-                                    std::vector<data_value_t> dvalues;
+                                    extract_vector<data_value_t> dvalues;
 
                                     get_tree_data_values (TREE_TYPE (def),
                                                           dvalues);
-                                    tvalue.values = dvalues;
+                                    tvalue.values = std::move (dvalues);
 
-                                    var.var_type = tvalue;
+                                    var.var_type = std::move (tvalue);
                                 }
 
                                 {
                                     tree_value_t tvalue;
-                                    std::vector<data_value_t> dvalues;
+                                    extract_vector<data_value_t> dvalues;
 
                                     get_tree_data_values (def, dvalues);
-                                    tvalue.values = dvalues;
+                                    tvalue.values = std::move (dvalues);
 
-                                    var.var_def = tvalue;
+                                    var.var_def = std::move (tvalue);
                                 }
 
                                 {
                                     tree_value_t tvalue;
-                                    std::vector<data_value_t> dvalues;
+                                    extract_vector<data_value_t> dvalues;
 
                                     get_tree_data_values (SSA_NAME_VAR (def),
                                                           dvalues);
-                                    tvalue.values = dvalues;
+                                    tvalue.values = std::move (dvalues);
 
-                                    var.var_ssa_name_var = tvalue;
+                                    var.var_ssa_name_var = std::move (tvalue);
                                 }
                             }
 
                         {
                             tree_value_t tvalue;
-                            std::vector<data_value_t> dvalues;
+                            extract_vector<data_value_t> dvalues;
 
                             data_value_t dvalue;
                             get_basic_tree_node_info (arg, dvalue);
 
                             print_declaration (arg, dvalues, dvalue);
-                            tvalue.values = dvalues;
+                            tvalue.values = std::move (dvalues);
 
-                            var.var_declaration = tvalue;
+                            var.var_declaration = std::move (tvalue);
                         }
 
                         tree_value_t tvalue;
-                        std::vector<data_value_t> dvalues;
+                        extract_vector<data_value_t> dvalues;
 
                         get_tree_data_values (arg, dvalues);
-                        tvalue.values = dvalues;
+                        tvalue.values = std::move (dvalues);
 
-                        var.arg = tvalue;
-                        fn_data.fn_args.push_back (var);
+                        var.arg = std::move (tvalue);
+                        fn_data.fn_args.push_back (std::move (var));
                     }
             }
 
+        extract_stats_lap (stats, EXTRACT_PHASE_ARGS, clock);
+
         if (fun->local_decls)
             {
                 tree arg;
@@ -211,242 +432,1274 @@ struct gimple_extractor_pass : gimple_opt_pass
 
                             {
                                 tree_value_t tvalue;
-                                std::vector<data_value_t> dvalues;
+                                extract_vector<data_value_t> dvalues;
 
                                 get_tree_data_values (arg, dvalues);
-                                tvalue.values = dvalues;
+                                tvalue.values = std::move (dvalues);
 
-                                var.arg = tvalue;
+                                var.arg = std::move (tvalue);
                             }
 
                             {
                                 tree_value_t tvalue;
-                                std::vector<data_value_t> dvalues;
+                                extract_vector<data_value_t> dvalues;
 
                                 data_value_t dvalue;
                                 get_basic_tree_node_info (arg, dvalue);
 
                                 print_declaration (arg, dvalues, dvalue);
-                                tvalue.values = dvalues;
+                                tvalue.values = std::move (dvalues);
+
+                                var.var_declaration = std::move (tvalue);
+                            }
+
+                            fn_data.fn_local_variables.push_back (std::move (var));
+                        }
+                }
+            }
+
+        extract_stats_lap (stats, EXTRACT_PHASE_LOCALS, clock);
+
+        if (gimple_in_ssa_p (fun))
+            {
+                unsigned i;
+                tree name;
+                FOR_EACH_SSA_NAME (i, name, fun)
+                {
+                    if (!SSA_NAME_VAR (name))
+                        {
+                            fn_ssa_variable_t var;
+
+                            {
+                                tree_value_t tvalue;
+                                extract_vector<data_value_t> dvalues;
+
+                                get_tree_data_values (TREE_TYPE (name),
+                                                      dvalues);
+                                tvalue.values = std::move (dvalues);
+
+                                var.var_type = std::move (tvalue);
+                            }
+
+                            {
+                                tree_value_t tvalue;
+                                extract_vector<data_value_t> dvalues;
 
-                                var.var_declaration = tvalue;
+                                get_tree_data_values (name, dvalues);
+                                tvalue.values = std::move (dvalues);
+
+                                var.arg = std::move (tvalue);
                             }
 
-                            fn_data.fn_local_variables.push_back (var);
+                            fn_data.fn_ssa_variables.push_back (std::move (var));
                         }
                 }
             }
 
-        if (gimple_in_ssa_p (fun))
-            {
-                unsigned i;
-                tree name;
-                FOR_EACH_SSA_NAME (i, name, fun)
-                {
-                    if (!SSA_NAME_VAR (name))
-                        {
-                            fn_ssa_variable_t var;
+        for (unsigned i = 1; i < fun->gimple_df->ssa_names->length (); ++i)
+            {
+                tree name = ssa_name (i);
+                if (name)
+                    {
+                        tree_value_t tvalue;
+                        extract_vector<data_value_t> dvalues;
+
+                        get_tree_data_values (name, dvalues);
+
+                        tvalue.values = std::move (dvalues);
+                        fn_data.fn_ssa_names.push_back (std::move (tvalue));
+                    }
+            }
+
+        extract_stats_lap (stats, EXTRACT_PHASE_SSA, clock);
+
+        edge e;
+        edge_iterator ei;
+        basic_block bb;
+
+        extract_vector<gimple_stmt_data> &stmt_data_list
+            = job->data->stmt_data_list;
+        extract_vector<basicblock_t> &basic_block_list
+            = job->data->basic_block_list;
+
+        FOR_EACH_BB_FN (bb, fun)
+        {
+            gimple_bb_info *bb_info = &bb->il.gimple;
+            extract_vector<int> bb_edges;
+
+            FOR_EACH_EDGE (e, ei, bb->succs)
+            {
+                basic_block succ_bb = e->dest;
+                bb_edges.push_back (succ_bb->index);
+            }
+
+            basicblock_t bb_data;
+            bb_data.bb_index = bb->index;
+            bb_data.bb_edges = bb_edges;
+
+            dump_phi_nodes (bb, bb_data);
+
+            gimple_stmt_iterator i;
+            for (i = gsi_start (bb_info->seq); !gsi_end_p (i); gsi_next (&i))
+                {
+                    gimple *gs = gsi_stmt (i);
+                    gimple_stmt_data stmt_data
+                        = gimple_tuple_to_stmt_data (gs, bb->index, bb_edges);
+                    stmt_data_list.push_back (std::move (stmt_data));
+                }
+
+            basic_block_list.push_back (std::move (bb_data));
+        }
+
+        take_tree_data_values_cache (job->data->shared_tree_values);
+
+        // TYPE_UIDs are only unique within a compilation
+        if (config_type_table)
+            fn_data.fn_type_table = get_unit_type_table_name ();
+
+        extract_stats_lap (stats, EXTRACT_PHASE_STMTS, clock);
+        stats.stmt_count = stmt_data_list.size ();
+
+        if (config_cfg_info)
+            {
+                get_cfg_info (fun, job->data->cfg_info);
+                extract_stats_lap (stats, EXTRACT_PHASE_CFG, clock);
+            }
+
+        // run () installs the arena again wherever it runs
+        arena_scope.close ();
+
+        if (async_writer_is_running ())
+            {
+                // the pack path depends on compiler state, open it here
+                if (config_output_mode != "file")
+                    open_unit_data_pack ();
+
+                // the writer pool owns the job's arena from here on
+                async_writer_submit (std::move (job));
+            }
+        else
+            {
+                job->run ();
+                job->commit ();
+            }
+
+        return 0;
+    }
+
+    virtual gimple_extractor_pass *
+    clone () override
+    {
+        // We do not clone ourselves
+        return this;
+    }
+};
+}
+
+void
+function_write_job::run ()
+{
+    extract_arena_scope arena_scope (arena);
+    uint64_t clock = extract_stats_clock ();
+
+    fn_extract_dump = function_to_string_dump (
+        data->stmt_data_list, data->basic_block_list, data->fn_data,
+        data->cfg_info, config_data_format, config_data_encoding);
+
+    extract_stats_lap (stats, EXTRACT_PHASE_SERIALIZE, clock);
+    stats.output_size = fn_extract_dump.size ();
+
+    if (is_fingerprinted)
+        {
+            fingerprint = get_output_fingerprint (fn_extract_dump);
+            extract_stats_lap (stats, EXTRACT_PHASE_FINGERPRINT, clock);
+        }
+}
+
+void
+function_write_job::commit ()
+{
+    function_data_t &fn_data = data->fn_data;
+    uint64_t clock = extract_stats_clock ();
+
+    std::string record_prefix = stage_dir.empty () ? "" : stage_dir + "/";
+
+    // an unchanged output keeps its file, and its mtime
+    if (is_fingerprinted
+        && extract_manifest_is_unchanged (unit_manifest, output_path,
+                                          fingerprint))
+        {
+            extract_manifest_record (unit_manifest, output_path, fingerprint);
+            extract_stats_add_skipped (unit_stats, stats);
+            // the file exists, so a dedup claim on it stays held
+            output_written = true;
+
+            if (extract_log_enabled (EXTRACT_LOG_VERBOSE))
+                extract_log (EXTRACT_LOG_VERBOSE,
+                             "[gimple-extractor] unchanged ... ["
+                                 + fn_data.fn_filename + "] -- "
+                                 + fn_data.fn_name);
+            return;
+        }
+
+    if (config_output_mode == "file")
+        {
+            write_function_to_file (fn_data.fn_filename, output_name,
+                                    stage_dir, fn_extract_dump);
+            output_written = true;
+        }
+    else if (config_output_mode == "shard")
+        write_function_to_pack (record_prefix + fn_data.fn_filename + ":"
+                                    + output_name,
+                                fn_extract_dump);
+    else
+        write_function_to_pack (record_prefix + output_name, fn_extract_dump);
+
+    if (config_incremental)
+        extract_manifest_record (unit_manifest, output_path, fingerprint);
+
+    extract_stats_lap (stats, EXTRACT_PHASE_WRITE, clock);
+    stats.name = fn_data.fn_name;
+    stats.filename = fn_data.fn_filename;
+    stats.stage = stage_dir;
+    extract_stats_add_function (unit_stats, stats);
+
+    if (extract_log_enabled (EXTRACT_LOG_VERBOSE))
+        extract_log (EXTRACT_LOG_VERBOSE, "[gimple-extractor] done ... ["
+                                              + fn_data.fn_filename + "] -- "
+                                              + fn_data.fn_name);
+}
+
+static void
+gimple_extractor_all_ipa_passes_end (void *gcc_data, void *user_data)
+{
+    if (config_lto && is_extracting_compilation ())
+        collect_unit_symbol_table ();
+
+    if (config_call_graph && is_extracting_compilation ())
+        collect_unit_call_graph ();
+}
+
+static void
+gimple_extractor_finish_unit (void *gcc_data, void *user_data)
+{
+    // every function of the unit must be in the pack before it is closed
+    async_writer_drain ();
+
+    if (config_lto && !in_lto_p && !flag_generate_lto)
+        std::cerr << "[gimple-extractor] lto=yes but " << get_unit_filename ()
+                  << " is not compiled with -flto, nothing extracted"
+                  << std::endl;
+
+    write_unit_type_table ();
+    write_unit_symbol_table ();
+    write_unit_call_graph ();
+
+    // a shard collects every unit of the process
+    if (config_output_mode == "pack" && !data_pack_close (unit_data_pack))
+        {
+            std::cerr << "[gimple-extractor] error writing pack file "
+                      << unit_data_pack.path << std::endl;
+        }
+
+    // the manifest must not list outputs that could still be lost
+    std::string error;
+    if (!sync_output_files (error))
+        std::cerr << "[gimple-extractor] " << error << std::endl;
+
+    std::string manifest_dir_path = unit_manifest.path.substr (
+        0, unit_manifest.path.find_last_of ('/'));
+    if (unit_manifest.is_open
+        && !create_output_directories (manifest_dir_path))
+        {
+            std::cerr << "[gimple-extractor] error creating directory "
+                      << manifest_dir_path << std::endl;
+        }
+
+    if (!extract_manifest_close (unit_manifest))
+        {
+            std::cerr << "[gimple-extractor] error writing manifest "
+                      << unit_manifest.path << std::endl;
+        }
+
+    write_unit_stats ();
+    extract_log_flush ();
+
+    if (!sync_output_files (error))
+        std::cerr << "[gimple-extractor] " << error << std::endl;
+
+    clear_source_cache ();
+}
+
+static void
+gimple_extractor_finish (void *gcc_data, void *user_data)
+{
+    async_writer_stop ();
+    clear_extract_arena_pool ();
+
+    if (!data_pack_close (unit_data_pack))
+        {
+            std::cerr << "[gimple-extractor] error writing pack file "
+                      << unit_data_pack.path << std::endl;
+        }
+
+    std::string error;
+    if (!sync_output_files (error))
+        std::cerr << "[gimple-extractor] " << error << std::endl;
+
+    close_output_dirs ();
+    extract_log_flush ();
+}
+
+int
+plugin_init (struct plugin_name_args *plugin_info,
+             struct plugin_gcc_version *version)
+{
+    if (!plugin_default_version_check (version, &gcc_version))
+        {
+            std::cerr << "This GCC plugin is for version "
+                      << GCCPLUGIN_VERSION_MAJOR << "."
+                      << GCCPLUGIN_VERSION_MINOR << "\n";
+            return 1;
+        }
+
+    register_callback (plugin_info->base_name,
+                       /* event */ PLUGIN_INFO,
+                       /* callback */ NULL,
+                       /* user_data */ &my_gcc_plugin_info);
+
+    bool passes_given = false;
+
+    for (int i = 0; i < plugin_info->argc; i++)
+        {
+            std::string key = std::string(plugin_info->argv[i].key);
+            std::string val = std::string(plugin_info->argv[i].value);
+
+            // ROOT or ROOT=OUTPUT_SUBDIR, may be given several times
+            if (key == "source_path") {
+                size_t pos = val.find ('=');
+                std::string root = val.substr (0, pos);
+                std::string output_subdir;
+                if (pos != std::string::npos)
+                    output_subdir = val.substr (pos + 1);
+
+                if (!add_source_root (root, output_subdir))
+                    {
+                        std::cerr << "[gimple-extractor] source_path: "
+                                     "cannot resolve "
+                                  << root << std::endl;
+                        return 1;
+                    }
+            }
+
+            if (key == "output_path") {
+                config_output_path = val;
+                config_output_path = get_full_path(config_output_path, false);
+            }
+
+            if (key == "data_format") {
+                if (val == "json")
+                    config_data_format = "json";
+
+                if (val == "msgpack")
+                    config_data_format = "msgpack";
+            }
+
+            if (key == "encoding") {
+                if (val == "default")
+                    config_data_encoding = "default";
+
+                if (val == "compact")
+                    config_data_encoding = "compact";
+            }
+
+            if (key == "type_table") {
+                if (val == "yes")
+                    config_type_table = true;
+
+                if (val == "no")
+                    config_type_table = false;
+            }
+
+            if (key == "output_mode") {
+                if (val == "file")
+                    config_output_mode = "file";
+
+                if (val == "pack")
+                    config_output_mode = "pack";
+
+                if (val == "shard")
+                    config_output_mode = "shard";
+            }
+
+            // comma separated pass names, e.g. ssa,optimized
+            if (key == "passes") {
+                std::vector<std::string> passes;
+                std::stringstream ss (val);
+                std::string pass_name;
+                while (std::getline (ss, pass_name, ','))
+                    {
+                        if (!pass_name.empty ()
+                            && std::find (passes.begin (), passes.end (),
+                                          pass_name)
+                                   == passes.end ())
+                            passes.push_back (pass_name);
+                    }
+
+                if (!passes.empty ())
+                    {
+                        config_passes = passes;
+                        passes_given = true;
+                    }
+            }
+
+            if (key == "output_naming") {
+                if (val == "name")
+                    config_output_naming = "name";
+
+                if (val == "asm")
+                    config_output_naming = "asm";
+            }
+
+            if (key == "async_write") {
+                if (val == "yes")
+                    config_async_write = true;
+
+                if (val == "no")
+                    config_async_write = false;
+            }
+
+            if (key == "jobs") {
+                int jobs = atoi (val.c_str ());
+                if (jobs > 0)
+                    config_jobs = jobs;
+            }
+
+            if (key == "incremental") {
+                if (val == "yes")
+                    config_incremental = true;
+
+                if (val == "no")
+                    config_incremental = false;
+            }
+
+            if (key == "stats") {
+                if (val == "yes")
+                    config_stats = true;
+
+                if (val == "no")
+                    config_stats = false;
+            }
+
+            if (key == "include" || key == "exclude") {
+                std::string error;
+                if (!extract_filter_add (key == "exclude", val, error))
+                    {
+                        std::cerr << "[gimple-extractor] " << key << ": "
+                                  << error << std::endl;
+                        return 1;
+                    }
+            }
+
+            if (key == "filter_file") {
+                std::string error;
+                if (!extract_filter_load (val, error))
+                    {
+                        std::cerr << "[gimple-extractor] " << error
+                                  << std::endl;
+                        return 1;
+                    }
+            }
+
+            if (key == "fsync") {
+                if (val == "none")
+                    config_fsync = OUTPUT_FSYNC_NONE;
+
+                if (val == "unit")
+                    config_fsync = OUTPUT_FSYNC_UNIT;
+
+                if (val == "file")
+                    config_fsync = OUTPUT_FSYNC_FILE;
+            }
+
+            if (key == "dedup") {
+                if (val == "yes")
+                    config_dedup = true;
+
+                if (val == "no")
+                    config_dedup = false;
+            }
+
+            if (key == "call_graph") {
+                if (val == "yes")
+                    config_call_graph = true;
+
+                if (val == "no")
+                    config_call_graph = false;
+            }
+
+            if (key == "cfg_info") {
+                if (val == "yes")
+                    config_cfg_info = true;
+
+                if (val == "no")
+                    config_cfg_info = false;
+            }
+
+            if (key == "lto") {
+                if (val == "yes")
+                    config_lto = true;
+
+                if (val == "no")
+                    config_lto = false;
+            }
+
+            if (key == "lto_name" && !val.empty ())
+                config_lto_name = val;
+
+            if (key == "log_level") {
+                if (val == "quiet")
+                    config_log_level = EXTRACT_LOG_QUIET;
+
+                if (val == "summary")
+                    config_log_level = EXTRACT_LOG_SUMMARY;
+
+                if (val == "verbose")
+                    config_log_level = EXTRACT_LOG_VERBOSE;
+            }
+        }
+
+    // bodies reach the link-time compilation in SSA form, the lowering
+    // passes never run there
+    if (config_lto && !passes_given)
+        config_passes = { "optimized" };
+
+    // created by the first output written, failures show up there
+    open_output_dirs (config_output_path);
+
+    // -ftime-report prints the timings without writing a stats file, the
+    // unit summary line needs them too
+    extract_stats_enabled = config_stats || time_report
+                            || extract_log_enabled (EXTRACT_LOG_SUMMARY);
+
+    // a pack or type table is rebuilt from every function of the unit
+    if (config_incremental
+        && (config_output_mode != "file" || config_type_table))
+        {
+            std::cerr << "[gimple-extractor] incremental=yes needs "
+                         "output_mode=file and type_table=no, ignored"
+                      << std::endl;
+            config_incremental = false;
+        }
+
+    // an output written by another plugin or GCC version, or with other
+    // options, never matches
+    if (config_incremental)
+        {
+            fingerprint_add (output_fingerprint_salt,
+                             std::string (my_gcc_plugin_info.version));
+            fingerprint_add (output_fingerprint_salt,
+                             std::string (gcc_version.basever));
+            fingerprint_add (output_fingerprint_salt,
+                             std::string (gcc_version.datestamp));
+            fingerprint_add (output_fingerprint_salt, config_data_format);
+            fingerprint_add (output_fingerprint_salt, config_data_encoding);
+            fingerprint_add (output_fingerprint_salt,
+                             (int64_t)config_type_table);
+            fingerprint_add (output_fingerprint_salt,
+                             (int64_t)config_cfg_info);
+        }
+
+    // claims sit next to the function outputs they guard
+    if (config_dedup && config_output_mode != "file")
+        {
+            std::cerr << "[gimple-extractor] dedup=yes needs "
+                         "output_mode=file, ignored"
+                      << std::endl;
+            config_dedup = false;
+        }
+
+    // more than one job only makes sense with the writer pool
+    if (config_async_write || config_jobs > 1)
+        async_writer_start (config_jobs, ASYNC_WRITER_QUEUE_SIZE);
+
+    // one instance per pass, all of them share the unit's caches
+    for (auto &pass_name : config_passes)
+        {
+            struct register_pass_info pass_info;
+
+            pass_info.pass = new gimple_extractor_pass (g, pass_name);
+            pass_info.reference_pass_name = pass_name.c_str ();
+            pass_info.ref_pass_instance_number = 1;
+            pass_info.pos_op = PASS_POS_INSERT_AFTER;
+
+            register_callback (plugin_info->base_name,
+                               PLUGIN_PASS_MANAGER_SETUP, NULL, &pass_info);
+        }
+
+    register_callback (plugin_info->base_name, PLUGIN_ALL_IPA_PASSES_END,
+                       gimple_extractor_all_ipa_passes_end, NULL);
+
+    register_callback (plugin_info->base_name, PLUGIN_FINISH_UNIT,
+                       gimple_extractor_finish_unit, NULL);
+
+    register_callback (plugin_info->base_name, PLUGIN_FINISH,
+                       gimple_extractor_finish, NULL);
+
+    return 0;
+}
+
+
+/* Outputs of each pass go to their own subdirectory when functions are
+   extracted after several passes.  */
+std::string
+get_stage_dir (std::string stage)
+{
+    if (config_passes.size () < 2)
+        return "";
+    return stage;
+}
+
+std::string
+get_output_dir_path (std::string filename, std::string stage_dir)
+{
+    const source_root_t *root = find_source_root (filename);
+
+    // files outside of the source roots go to the root of output_path
+    std::string output_filename_without_source_path;
+    if (root)
+        output_filename_without_source_path
+            = filename.substr (root->path.size ());
+    else
+        output_filename_without_source_path
+            = filename.substr (filename.find_last_of ('/') + 1);
+    std::replace (output_filename_without_source_path.begin (),
+                  output_filename_without_source_path.end (), '.', '_');
+
+    // may run on the writer thread, so leave config_output_path alone
+    std::string output_path = config_output_path;
+    if (!stage_dir.empty ())
+        {
+            if (ends_with_char (output_path, '/') == false)
+                output_path += "/";
+            output_path += stage_dir;
+        }
+
+    if (root && !root->output_subdir.empty ())
+        {
+            if (ends_with_char (output_path, '/') == false)
+                output_path += "/";
+            output_path += root->output_subdir;
+        }
+
+    if (ends_with_char (output_path, '/') == false)
+        {
+            if (starts_with_char (output_filename_without_source_path, '/')
+                == false)
+                {
+                    output_path += "/";
+                }
+        }
+
+    return output_path + output_filename_without_source_path;
+}
+
+/* With output_naming=asm functions are named after their assembler name,
+   which tells overloads apart; local functions get the unit hash on top,
+   as the same static function of a header may differ between units.  */
+std::string
+get_function_output_name (function *fun, const function_data_t &fn_data)
+{
+    if (config_output_naming != "asm")
+        return fn_data.fn_name;
+
+    std::string output_name
+        = IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (fun->decl));
+    if (!TREE_PUBLIC (fun->decl))
+        output_name += "." + get_unit_hash ();
+
+    return output_name;
+}
+
+std::string
+get_function_output_path (std::string filename, std::string function_name,
+                          std::string stage_dir)
+{
+    std::string output_function_name = function_name;
+
+    std::replace (output_function_name.begin (), output_function_name.end (),
+                  ':', '_');
+    std::replace (output_function_name.begin (), output_function_name.end (),
+                  '~', '_');
+    std::replace (output_function_name.begin (), output_function_name.end (),
+                  '+', '_');
+
+    return get_output_dir_path (filename, stage_dir) + "/"
+           + output_function_name + "." + config_data_format;
+}
+
+void
+write_function_to_file (std::string filename, std::string function_name,
+                        std::string stage_dir,
+                        std::string function_extract_dump)
+{
+    std::string output_full_path
+        = get_function_output_path (filename, function_name, stage_dir);
+    std::string output_dir_path
+        = output_full_path.substr (0, output_full_path.find_last_of ('/'));
+
+    if (!create_output_directories (output_dir_path))
+        {
+            throw std::runtime_error ("Error creating extract directory");
+        }
+
+    // std::cout << output_full_path << std::endl;
+
+    std::string error;
+    if (!write_output_file (output_full_path, function_extract_dump, error))
+        {
+            throw std::runtime_error (error);
+        }
+}
+
+/* Link-time units are named after the program, their input is a temporary
+   file.  Each LTRANS partition keeps its number so that partitions never
+   overwrite each other's unit outputs.  */
+std::string
+get_lto_unit_name ()
+{
+    std::string unit_name = config_lto_name;
+    std::string input_filename = main_input_filename ? main_input_filename : "";
+
+    // <temp>.ltrans<N>.o
+    size_t pos = input_filename.rfind (".ltrans");
+    if (pos != std::string::npos)
+        {
+            size_t end = input_filename.find ('.', pos + 1);
+            unit_name += input_filename.substr (pos, end - pos);
+        }
+
+    return unit_name;
+}
+
+std::string
+get_unit_filename ()
+{
+    if (config_lto && in_lto_p)
+        return "/" + get_lto_unit_name ();
+
+    std::string unit_filename = "/unit";
+    if (main_input_filename
+        && !get_canonical_path (main_input_filename, unit_filename))
+        unit_filename = main_input_filename;
+
+    return unit_filename;
+}
+
+/* Short hash of the unit's path, tells apart units with the same name.  */
+std::string
+get_unit_hash ()
+{
+    fingerprint_t fp;
+    fingerprint_add (fp, get_unit_filename ());
+
+    char hex[9];
+    snprintf (hex, sizeof (hex), "%08x", static_cast<unsigned> (fp.hash));
+    return hex;
+}
+
+std::string
+get_unit_output_path ()
+{
+    return get_output_dir_path (get_unit_filename (), "");
+}
+
+/* Shards are named after the first unit of the process and its pid, so
+   that concurrent compilations never write to the same file.  */
+std::string
+get_unit_shard_path ()
+{
+    std::string unit_filename = get_unit_filename ();
+    std::string unit_basename
+        = unit_filename.substr (unit_filename.find_last_of ('/') + 1);
+    std::replace (unit_basename.begin (), unit_basename.end (), '.', '_');
+
+    std::string output_path = config_output_path;
+    if (ends_with_char (output_path, '/') == false)
+        output_path += "/";
+
+    return output_path + "shards/" + unit_basename + "." + get_unit_hash ()
+           + "." + std::to_string (getpid ()) + ".pack";
+}
+
+std::string
+get_unit_pack_path ()
+{
+    return get_unit_output_path () + ".pack";
+}
+
+void
+open_unit_data_pack ()
+{
+    if (unit_data_pack.is_open)
+        return;
+
+    std::string pack_path = config_output_mode == "shard"
+                                ? get_unit_shard_path ()
+                                : get_unit_pack_path ();
+    std::string pack_dir_path
+        = pack_path.substr (0, pack_path.find_last_of ('/'));
+
+    if (!create_output_directories (pack_dir_path))
+        {
+            throw std::runtime_error ("Error creating extract directory");
+        }
+
+    if (!data_pack_open (unit_data_pack, pack_path, config_data_format))
+        {
+            throw std::runtime_error ("Error creating extract pack");
+        }
+}
+
+void
+write_function_to_pack (std::string function_name,
+                        std::string function_extract_dump)
+{
+    open_unit_data_pack ();
+    data_pack_append (unit_data_pack, function_name, function_extract_dump);
+}
+
+/* Tables of the whole unit are written next to its functions: as the
+   RECORD_NAME record of a pack (suffixed with the unit in a shard), or as
+   the unit's .SUFFIX file.  */
+static void
+write_unit_table (std::string record_name, std::string suffix,
+                  std::string table_dump)
+{
+    if (config_output_mode == "pack")
+        {
+            write_function_to_pack (record_name, table_dump);
+            return;
+        }
+
+    if (config_output_mode == "shard")
+        {
+            write_function_to_pack (record_name + ":" + get_unit_filename (),
+                                    table_dump);
+            return;
+        }
+
+    std::string output_full_path
+        = get_unit_output_path () + "." + suffix;
+    std::string output_dir_path
+        = output_full_path.substr (0, output_full_path.find_last_of ('/'));
+
+    if (!create_output_directories (output_dir_path))
+        {
+            throw std::runtime_error ("Error creating extract directory");
+        }
+
+    std::string error;
+    if (!write_output_file (output_full_path, table_dump, error))
+        {
+            throw std::runtime_error (error);
+        }
+}
+
+/* The pack record of the unit's type table, or in file mode its path
+   relative to output_path.  */
+std::string
+get_unit_type_table_name ()
+{
+    if (config_output_mode == "pack")
+        return "__types__";
+
+    if (config_output_mode == "shard")
+        return "__types__:" + get_unit_filename ();
+
+    std::string output_path = config_output_path;
+    if (ends_with_char (output_path, '/') == false)
+        output_path += "/";
+
+    std::string path
+        = get_unit_output_path () + ".types." + config_data_format;
+    if (path.compare (0, output_path.size (), output_path) == 0)
+        path = path.substr (output_path.size ());
+    path.erase (0, path.find_first_not_of ('/'));
+    return path;
+}
+
+void
+write_unit_type_table ()
+{
+    if (unit_type_table.empty ())
+        return;
+
+    std::string type_table_dump
+        = type_table_to_string_dump (unit_type_table, config_data_format,
+                                     config_data_encoding);
+    unit_type_table.clear ();
+
+    write_unit_table ("__types__", "types." + config_data_format,
+                      type_table_dump);
+}
+
+/* Every function and variable the compilation defines within the source
+   roots.  In a link-time compilation this is the symbol table after the
+   copies of all units were merged, so with a single partition it covers
+   the whole program; symbols of other partitions are left to them.
+   Collected once the IPA passes are done, before the bodies are expanded
+   and released.  */
+void
+collect_unit_symbol_table ()
+{
+    symbol_table_t &symbol_table = unit_symbol_table;
+    symtab_node *node;
+
+    symbol_table.clear ();
 
-                            {
-                                tree_value_t tvalue;
-                                std::vector<data_value_t> dvalues;
+    FOR_EACH_SYMBOL (node)
+    {
+        if (!node->definition || node->alias || node->in_other_partition)
+            continue;
+
+        cgraph_node *cnode = dyn_cast<cgraph_node *> (node);
+        if (cnode && cnode->inlined_to)
+            continue;
+
+        const char *source_filename = DECL_SOURCE_FILE (node->decl);
+        std::string filename;
+        if (!source_filename
+            || !get_canonical_path (source_filename, filename)
+            || !find_source_root (filename))
+            continue;
+
+        symbol_data_t symbol;
+        symbol.kind = cnode ? "function" : "variable";
+        symbol.name = node->name ();
+        symbol.asm_name = node->asm_name ();
+        symbol.filename = filename;
+        symbol.line = DECL_SOURCE_LINE (node->decl);
+        symbol.is_public = TREE_PUBLIC (node->decl);
+        symbol.is_comdat = DECL_COMDAT (node->decl);
+        symbol_table.push_back (std::move (symbol));
+    }
 
-                                get_tree_data_values (TREE_TYPE (name),
-                                                      dvalues);
-                                tvalue.values = dvalues;
+    std::sort (symbol_table.begin (), symbol_table.end (),
+               [] (const symbol_data_t &a, const symbol_data_t &b) {
+                   return a.asm_name < b.asm_name;
+               });
+}
 
-                                var.var_type = tvalue;
-                            }
+void
+write_unit_symbol_table ()
+{
+    if (unit_symbol_table.empty ())
+        return;
 
-                            {
-                                tree_value_t tvalue;
-                                std::vector<data_value_t> dvalues;
+    std::string symbol_table_dump
+        = symbol_table_to_string_dump (unit_symbol_table, config_data_format,
+                                       config_data_encoding);
+    unit_symbol_table.clear ();
 
-                                get_tree_data_values (name, dvalues);
-                                tvalue.values = dvalues;
+    write_unit_table ("__symbols__", "symbols." + config_data_format,
+                      symbol_table_dump);
+}
 
-                                var.arg = tvalue;
-                            }
+/* Functions are call graph nodes under the name of the function they were
+   cloned from, so that inline copies and IPA clones (constprop, isra...)
+   report their calls as the source does.  */
+static uint32_t
+add_call_graph_node (cgraph_node *node)
+{
+    while (node->clone_of)
+        node = node->clone_of;
+
+    uint32_t flags = 0;
+    if (node->definition)
+        flags |= CALL_GRAPH_NODE_DEFINED;
+    if (TREE_PUBLIC (node->decl))
+        flags |= CALL_GRAPH_NODE_PUBLIC;
+    if (node->address_taken)
+        flags |= CALL_GRAPH_NODE_ADDRESS_TAKEN;
+    if (DECL_COMDAT (node->decl))
+        flags |= CALL_GRAPH_NODE_COMDAT;
+
+    return call_graph_add_node (unit_call_graph, node->asm_name (), flags);
+}
 
-                            fn_data.fn_ssa_variables.push_back (var);
-                        }
-                }
-            }
+static uint32_t
+get_call_line (cgraph_edge *e)
+{
+    if (!e->call_stmt)
+        return 0;
+    return gimple_lineno (e->call_stmt);
+}
 
-        for (unsigned i = 1; i < fun->gimple_df->ssa_names->length (); ++i)
-            {
-                tree name = ssa_name (i);
-                if (name)
-                    {
-                        tree_value_t tvalue;
-                        std::vector<data_value_t> dvalues;
+/* Calls of every function defined within the source roots.  The callgraph
+   edges are removed as soon as a function is expanded, so they are
+   collected once the IPA passes are done.  */
+void
+collect_unit_call_graph ()
+{
+    cgraph_node *node;
 
-                        get_tree_data_values (name, dvalues);
+    call_graph_clear (unit_call_graph);
+    unit_call_graph.unit = get_unit_filename ();
 
-                        tvalue.values = dvalues;
-                        fn_data.fn_ssa_names.push_back (tvalue);
-                    }
-            }
+    FOR_EACH_FUNCTION (node)
+    {
+        if (!node->definition || node->alias || node->in_other_partition)
+            continue;
+
+        const char *source_filename = DECL_SOURCE_FILE (node->decl);
+        std::string filename;
+        if (!source_filename
+            || !get_canonical_path (source_filename, filename)
+            || !find_source_root (filename))
+            continue;
+
+        uint32_t caller = add_call_graph_node (node);
+
+        for (cgraph_edge *e = node->callees; e; e = e->next_callee)
+            call_graph_add_edge (unit_call_graph, caller,
+                                 add_call_graph_node (e->callee),
+                                 get_call_line (e));
+
+        for (cgraph_edge *e = node->indirect_calls; e; e = e->next_callee)
+            call_graph_add_edge (unit_call_graph, caller,
+                                 e->indirect_info->polymorphic
+                                     ? CALL_GRAPH_VIRTUAL
+                                     : CALL_GRAPH_INDIRECT,
+                                 get_call_line (e));
+    }
+}
 
-        edge e;
-        edge_iterator ei;
-        basic_block bb;
+void
+write_unit_call_graph ()
+{
+    if (unit_call_graph.nodes.empty ())
+        return;
 
-        std::vector<gimple_stmt_data> stmt_data_list;
-        std::vector<basicblock_t> basic_block_list;
+    std::string call_graph_dump = call_graph_to_string (unit_call_graph);
+    call_graph_clear (unit_call_graph);
 
-        FOR_EACH_BB_FN (bb, fun)
-        {
-            gimple_bb_info *bb_info = &bb->il.gimple;
-            std::vector<int> bb_edges;
+    write_unit_table ("__callgraph__", "callgraph", call_graph_dump);
+}
 
-            FOR_EACH_EDGE (e, ei, bb->succs)
-            {
-                basic_block succ_bb = e->dest;
-                bb_edges.push_back (succ_bb->index);
-            }
+void
+write_unit_stats ()
+{
+    if (unit_stats.functions.empty () && unit_stats.skipped_count == 0)
+        return;
 
-            basicblock_t bb_data;
-            bb_data.bb_index = bb->index;
-            bb_data.bb_edges = bb_edges;
+    if (config_lto && in_lto_p)
+        unit_stats.unit = get_lto_unit_name ();
+    else
+        unit_stats.unit = main_input_filename ? main_input_filename : "";
 
-            dump_phi_nodes (bb, bb_data);
+    if (extract_log_enabled (EXTRACT_LOG_SUMMARY))
+        extract_log (EXTRACT_LOG_SUMMARY, extract_stats_summary (unit_stats));
 
-            gimple_stmt_iterator i;
-            for (i = gsi_start (bb_info->seq); !gsi_end_p (i); gsi_next (&i))
+    if (time_report)
+        extract_stats_print (unit_stats, std::cerr);
+
+    if (config_stats)
+        {
+            std::string output_full_path
+                = get_unit_output_path () + ".stats.json";
+            std::string output_dir_path = output_full_path.substr (
+                0, output_full_path.find_last_of ('/'));
+
+            if (!create_output_directories (output_dir_path)
+                || !extract_stats_write (unit_stats, output_full_path))
                 {
-                    gimple *gs = gsi_stmt (i);
-                    gimple_stmt_data stmt_data
-                        = gimple_tuple_to_stmt_data (gs, bb->index, bb_edges);
-                    stmt_data_list.push_back (stmt_data);
+                    std::cerr << "[gimple-extractor] error writing stats "
+                              << output_full_path << std::endl;
                 }
-
-            basic_block_list.push_back (bb_data);
         }
 
-        std::string fn_extract_dump = function_to_string_dump (
-            stmt_data_list, basic_block_list, fn_data, config_data_format);
-
-        write_function_to_file (fn_data.fn_filename, fn_data.fn_name,
-                                fn_extract_dump);
+    extract_stats_clear (unit_stats);
+}
 
-        std::cout << "[gimple-extractor] done ... [" << fn_data.fn_filename << "] -- "
-                  << fn_data.fn_name << std::endl;
+std::string
+get_unit_manifest_path ()
+{
+    return get_unit_output_path () + ".manifest";
+}
 
-        return 0;
-    }
+/* Fingerprint of the serialized output DUMP, for incremental mode.  The
+   bytes cover everything that is written, type and declaration
+   descriptions included; the salt covers the plugin, the GCC it runs in
+   and the options.  */
+uint64_t
+get_output_fingerprint (const std::string &dump)
+{
+    fingerprint_t fp = output_fingerprint_salt;
+    fingerprint_add (fp, dump);
+    return fp.hash;
+}
 
-    virtual gimple_extractor_pass *
-    clone () override
-    {
-        // We do not clone ourselves
-        return this;
-    }
-};
+static void
+fingerprint_add_pp (fingerprint_t &fp, pretty_printer *pp)
+{
+    fingerprint_add (fp, std::string (pp_formatted_text (pp)));
+    pp_clear_output_area (pp);
 }
 
-int
-plugin_init (struct plugin_name_args *plugin_info,
-             struct plugin_gcc_version *version)
+/* Hash FUN's body before extracting it, using GCC's own printers, which
+   is far cheaper than extracting it.  Names, types, locations and the CFG
+   are covered; printing of trees the extractor expands further (e.g.
+   struct layouts) is not, so this only keys dedup claims, where the owning
+   unit rewrites the output on every rebuild anyway.  Incremental mode
+   compares the output itself, see get_output_fingerprint ().  */
+uint64_t
+get_function_fingerprint (function *fun, const function_data_t &fn_data)
 {
-    if (!plugin_default_version_check (version, &gcc_version))
+    fingerprint_t fp;
+    pretty_printer pp;
+    dump_flags_t flags = TDF_LINENO | TDF_VOPS;
+
+    fingerprint_add (fp, config_data_format);
+    fingerprint_add (fp, config_data_encoding);
+    // only when enabled, so that existing claims stay valid
+    if (config_cfg_info)
+        fingerprint_add (fp, std::string ("cfg_info"));
+    fingerprint_add (fp, fn_data.fn_name);
+    fingerprint_add (fp, fn_data.fn_filename);
+    fingerprint_add (fp, (int64_t)fn_data.fn_start_line_no);
+    for (auto &line : fn_data.fn_source_lines)
         {
-            std::cerr << "This GCC plugin is for version "
-                      << GCCPLUGIN_VERSION_MAJOR << "."
-                      << GCCPLUGIN_VERSION_MINOR << "\n";
-            return 1;
+            fingerprint_add (fp, line.first);
+            fingerprint_add (fp, line.second);
         }
 
-    register_callback (plugin_info->base_name,
-                       /* event */ PLUGIN_INFO,
-                       /* callback */ NULL,
-                       /* user_data */ &my_gcc_plugin_info);
+    print_declaration (&pp, fun->decl, 0, flags);
+    fingerprint_add_pp (fp, &pp);
 
-    struct register_pass_info pass_info;
+    for (tree arg = DECL_ARGUMENTS (fun->decl); arg; arg = DECL_CHAIN (arg))
+        {
+            print_declaration (&pp, arg, 0, flags);
+            fingerprint_add_pp (fp, &pp);
+        }
 
-    pass_info.pass = new gimple_extractor_pass (g);
-    pass_info.reference_pass_name = "ssa";
-    pass_info.ref_pass_instance_number = 1;
-    pass_info.pos_op = PASS_POS_INSERT_AFTER;
+    tree var;
+    unsigned ix;
+    FOR_EACH_LOCAL_DECL (fun, ix, var)
+    {
+        print_declaration (&pp, var, 0, flags);
+        fingerprint_add_pp (fp, &pp);
+    }
 
-    for (int i = 0; i < plugin_info->argc; i++)
+    for (unsigned i = 1; i < fun->gimple_df->ssa_names->length (); ++i)
         {
-            std::string key = std::string(plugin_info->argv[i].key);
-            std::string val = std::string(plugin_info->argv[i].value);
-
-            if (key == "source_path") {
-                config_source_path = val;
-                config_source_path = get_full_path(config_source_path, true);
-            }
+            tree name = ssa_name (i);
+            if (!name)
+                continue;
+
+            dump_generic_node (&pp, TREE_TYPE (name), 0, flags, false);
+            pp_space (&pp);
+            dump_generic_node (&pp, name, 0, flags, false);
+            fingerprint_add_pp (fp, &pp);
+        }
 
-            if (key == "output_path") {
-                config_output_path = val;
-                config_output_path = get_full_path(config_output_path, false);
-            }
+    basic_block bb;
+    FOR_EACH_BB_FN (bb, fun)
+    {
+        edge e;
+        edge_iterator ei;
 
-            if (key == "data_format") {
-                if (val == "json")
-                    config_data_format = "json";
+        fingerprint_add (fp, (int64_t)bb->index);
+        FOR_EACH_EDGE (e, ei, bb->succs)
+        {
+            fingerprint_add (fp, (int64_t)e->dest->index);
+        }
 
-                if (val == "msgpack")
-                    config_data_format = "msgpack";
+        gimple_stmt_iterator i;
+        for (i = gsi_start_phis (bb); !gsi_end_p (i); gsi_next (&i))
+            {
+                pp_gimple_stmt_1 (&pp, gsi_stmt (i), 0, flags);
+                fingerprint_add_pp (fp, &pp);
             }
-        }
 
-    register_callback (plugin_info->base_name, PLUGIN_PASS_MANAGER_SETUP, NULL,
-                       &pass_info);
+        for (i = gsi_start_bb (bb); !gsi_end_p (i); gsi_next (&i))
+            {
+                pp_gimple_stmt_1 (&pp, gsi_stmt (i), 0, flags);
+                fingerprint_add_pp (fp, &pp);
+            }
+    }
 
-    return 0;
+    return fp.hash;
 }
 
-
+/* Dominators that the pass did not leave around are freed again once read,
+   so that later passes see the compiler's state unchanged.  Loops are only
+   read when they are up to date.  */
 void
-write_function_to_file (std::string filename, std::string function_name,
-                        std::string function_extract_dump)
+get_cfg_info (function *fun, cfg_info_t &cfg_info)
 {
-    std::string output_filename_without_source_path
-        = filename.substr (config_source_path.size ());
-    std::string output_function_name = function_name;
-    std::replace (output_filename_without_source_path.begin (),
-                  output_filename_without_source_path.end (), '.', '_');
+    int bb_count = last_basic_block_for_fn (fun);
+    cfg_info.bb_idom.assign (bb_count, -1);
+    cfg_info.bb_ipdom.assign (bb_count, -1);
+    cfg_info.bb_loop.assign (bb_count, -1);
 
-    std::replace (output_function_name.begin (), output_function_name.end (),
-                  ':', '_');
-    std::replace (output_function_name.begin (), output_function_name.end (),
-                  '~', '_');
-    std::replace (output_function_name.begin (), output_function_name.end (),
-                  '+', '_');
+    bool had_dominators = dom_info_available_p (fun, CDI_DOMINATORS);
+    bool had_post_dominators = dom_info_available_p (fun, CDI_POST_DOMINATORS);
 
-    if (ends_with_char (config_output_path, '/') == false)
-        {
-            if (starts_with_char (output_filename_without_source_path, '/')
-                == false)
-                {
-                    config_output_path += "/";
-                }
-        }
+    calculate_dominance_info (CDI_DOMINATORS);
+    calculate_dominance_info (CDI_POST_DOMINATORS);
 
-    std::string output_dir_path
-        = config_output_path + output_filename_without_source_path;
+    bool has_loops = loops_for_fn (fun)
+                     && !loops_state_satisfies_p (fun, LOOPS_NEED_FIXUP);
 
-    if (!create_directories (output_dir_path))
-        {
-            throw std::runtime_error ("Error creating extract directory");
-        }
+    basic_block bb;
+    FOR_ALL_BB_FN (bb, fun)
+    {
+        basic_block idom = get_immediate_dominator (CDI_DOMINATORS, bb);
+        if (idom)
+            cfg_info.bb_idom[bb->index] = idom->index;
 
-    std::string output_full_path = output_dir_path + "/" + output_function_name
-                                   + "." + config_data_format;
+        basic_block ipdom = get_immediate_dominator (CDI_POST_DOMINATORS, bb);
+        if (ipdom)
+            cfg_info.bb_ipdom[bb->index] = ipdom->index;
 
-    // std::cout << output_full_path << std::endl;
+        if (has_loops && bb->loop_father)
+            cfg_info.bb_loop[bb->index] = bb->loop_father->num;
+    }
+
+    if (!had_dominators)
+        free_dominance_info (CDI_DOMINATORS);
+    if (!had_post_dominators)
+        free_dominance_info (CDI_POST_DOMINATORS);
 
-    std::ofstream jsonfile;
-    jsonfile.open (output_full_path);
-    jsonfile << function_extract_dump;
-    jsonfile.close ();
+    if (!has_loops)
+        return;
+
+    unsigned loop_count = number_of_loops (fun);
+    cfg_info.loop_header.assign (loop_count, -1);
+    cfg_info.loop_latch.assign (loop_count, -1);
+    cfg_info.loop_depth.assign (loop_count, -1);
+    cfg_info.loop_outer.assign (loop_count, -1);
+
+    for (unsigned i = 0; i < loop_count; i++)
+        {
+            loop_p loop = get_loop (fun, i);
+            if (!loop)
+                continue;
+
+            if (loop->header)
+                cfg_info.loop_header[i] = loop->header->index;
+            // several latches until the loops are normalized
+            if (loop->latch)
+                cfg_info.loop_latch[i] = loop->latch->index;
+            cfg_info.loop_depth[i] = loop_depth (loop);
+            if (loop_outer (loop))
+                cfg_info.loop_outer[i] = loop_outer (loop)->num;
+        }
 }
 
 gimple_stmt_data
-gimple_tuple_to_stmt_data (gimple *g, int bb_index, std::vector<int> &bb_edges)
+gimple_tuple_to_stmt_data (gimple *g, int bb_index, extract_vector<int> &bb_edges)
 {
 
     gimple_stmt_data stmt_data;
@@ -514,12 +1767,12 @@ dump_gimple_phi (const gphi *phi)
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (lhs, dvalues);
 
-        tvalue.values = dvalues;
-        phi_data.phi_lhs = tvalue;
+        tvalue.values = std::move (dvalues);
+        phi_data.phi_lhs = std::move (tvalue);
     }
 
     for (i = 0; i < gimple_phi_num_args (phi); i++)
@@ -539,14 +1792,14 @@ dump_gimple_phi (const gphi *phi)
             gimple_phi_rhs.basic_block_src_index = src->index;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (gimple_phi_arg_def ((gphi*)phi, i), dvalues);
 
-            tvalue.values = dvalues;
-            gimple_phi_rhs.phi_rhs = tvalue;
+            tvalue.values = std::move (dvalues);
+            gimple_phi_rhs.phi_rhs = std::move (tvalue);
 
-            phi_data.gimple_phi_rhs_list.push_back (gimple_phi_rhs);
+            phi_data.gimple_phi_rhs_list.push_back (std::move (gimple_phi_rhs));
         }
 
     return phi_data;
@@ -563,7 +1816,7 @@ dump_phi_nodes (basic_block bb, basicblock_t &bb_data)
             if (!virtual_operand_p (gimple_phi_result (phi)))
                 {
                     gimple_phi_t gimple_phi = dump_gimple_phi (phi);
-                    bb_data.phis.push_back (gimple_phi);
+                    bb_data.phis.push_back (std::move (gimple_phi));
                 }
         }
 }
@@ -590,32 +1843,65 @@ gimple_tuple_args (gimple *g, gimple_stmt_data &stmt_data)
         {
             const tree tree_node = static_cast<const tree> (op);
 
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
             get_tree_data_values (tree_node, dvalues);
 
-            tree_value_t tvalue{ .values = dvalues };
-            stmt_data.tree_values.push_back (tvalue);
+            tree_value_t tvalue{ .values = std::move (dvalues) };
+            stmt_data.tree_values.push_back (std::move (tvalue));
         }
 }
 
+/* Append a value with the header of DVALUE (everything but its simple and
+   complex values, which are left for the caller to fill in).  */
+static data_value_t &
+append_value_header (extract_vector<data_value_t> &dvalues,
+                     const data_value_t &dvalue)
+{
+    dvalues.emplace_back ();
+
+    data_value_t &v = dvalues.back ();
+    v.value_type = dvalue.value_type;
+    v.code = dvalue.code;
+    v.code_class = dvalue.code_class;
+    v.code_name = dvalue.code_name;
+    v.is_expr = dvalue.is_expr;
+    v.operand_length = dvalue.operand_length;
+    v.has_inner_tree = dvalue.has_inner_tree;
+    v.location_file = dvalue.location_file;
+    v.location_line = dvalue.location_line;
+    v.location_column = dvalue.location_column;
+    v.type_id = dvalue.type_id;
+    v.token = dvalue.token;
+    return v;
+}
+
 void
-append_simple_value (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
+append_simple_value (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
                      std::string value)
 {
-    data_value_t v = dvalue;
-    v.value_type = "simple";
+    data_value_t &v = append_value_header (dvalues, dvalue);
+    v.value_type = DATA_VALUE_SIMPLE;
+    v.simple_data_value = std::move (value);
+}
+
+void
+append_token_value (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
+                    enum data_token token, const char *value)
+{
+    data_value_t &v = append_value_header (dvalues, dvalue);
+    v.value_type = DATA_VALUE_SIMPLE;
     v.simple_data_value = value;
-    dvalues.push_back (v);
+    v.token = token;
 }
 
+/* Takes COMPLEX_DVALUES over, callers must not use it afterwards.  */
 void
-append_complex_value (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
-                      std::vector<data_value_t> &complex_dvalues)
+append_complex_value (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
+                      extract_vector<data_value_t> &complex_dvalues)
 {
-    data_value_t v = dvalue;
-    v.value_type = "complex";
-    v.complex_data_values = complex_dvalues;
-    dvalues.push_back (v);
+    data_value_t &v = append_value_header (dvalues, dvalue);
+    v.value_type = DATA_VALUE_COMPLEX;
+    v.complex_data_values = std::move (complex_dvalues);
 }
 
 void
@@ -641,7 +1927,7 @@ get_basic_tree_node_info (tree tree_node, data_value_t &dvalue)
 }
 
 static void
-dump_fancy_name (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
+dump_fancy_name (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
                  tree name)
 {
     int cnt = 0;
@@ -713,7 +1999,7 @@ dump_fancy_name (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
 }
 
 void
-ppp_tree_identifier (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
+ppp_tree_identifier (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
                      tree id)
 {
     // if (pp_translate_identifiers(pp)) {
@@ -727,7 +2013,7 @@ ppp_tree_identifier (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
 }
 
 void
-dump_decl_name (tree node, std::vector<data_value_t> &dvalues,
+dump_decl_name (tree node, extract_vector<data_value_t> &dvalues,
                 data_value_t &dvalue)
 {
     tree name = DECL_NAME (node);
@@ -802,7 +2088,7 @@ dump_decl_name (tree node, std::vector<data_value_t> &dvalues,
 /* Print X to PP in decimal.  */
 template <unsigned int N, typename T>
 void
-ppp_wide_integer (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
+ppp_wide_integer (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
                   const poly_int_pod<N, T> &x)
 {
     if (x.is_constant ())
@@ -822,7 +2108,7 @@ ppp_wide_integer (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
 }
 
 static void
-dump_function_declaration (tree node, std::vector<data_value_t> &dvalues,
+dump_function_declaration (tree node, extract_vector<data_value_t> &dvalues,
                            data_value_t &dvalue)
 {
     bool wrote_arg = false;
@@ -861,7 +2147,7 @@ dump_function_declaration (tree node, std::vector<data_value_t> &dvalues,
 }
 
 static void
-do_niy (const_tree node, std::vector<data_value_t> &dvalues,
+do_niy (const_tree node, extract_vector<data_value_t> &dvalues,
         data_value_t &dvalue)
 {
     int i, len;
@@ -883,7 +2169,7 @@ do_niy (const_tree node, std::vector<data_value_t> &dvalues,
 }
 
 static void
-dump_mem_ref (tree node, std::vector<data_value_t> &dvalues,
+dump_mem_ref (tree node, extract_vector<data_value_t> &dvalues,
               data_value_t &dvalue)
 {
     ppp_string (dvalues, dvalue, "__MEM <");
@@ -1001,7 +2287,7 @@ dump_mem_ref (tree node, std::vector<data_value_t> &dvalues,
 }
 
 void
-pretty_print_string (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
+pretty_print_string (extract_vector<data_value_t> &dvalues, data_value_t &dvalue,
                      const char *str, size_t n)
 {
     if (str == NULL)
@@ -1069,7 +2355,7 @@ pretty_print_string (std::vector<data_value_t> &dvalues, data_value_t &dvalue,
 }
 
 static void
-dump_array_domain (tree domain, std::vector<data_value_t> &dvalues,
+dump_array_domain (tree domain, extract_vector<data_value_t> &dvalues,
                    data_value_t &dvalue)
 {
     ppp_left_bracket (dvalues, dvalue);
@@ -1104,7 +2390,7 @@ dump_array_domain (tree domain, std::vector<data_value_t> &dvalues,
 }
 
 void
-print_declaration (tree t, std::vector<data_value_t> &dvalues,
+print_declaration (tree t, extract_vector<data_value_t> &dvalues,
                    data_value_t &dvalue)
 {
     int spc = 1;
@@ -1211,7 +2497,7 @@ print_declaration (tree t, std::vector<data_value_t> &dvalues,
 }
 
 static void
-dump_function_name (tree node, std::vector<data_value_t> &dvalues,
+dump_function_name (tree node, extract_vector<data_value_t> &dvalues,
                     data_value_t &dvalue)
 {
     if (CONVERT_EXPR_P (node))
@@ -1230,7 +2516,7 @@ dump_function_name (tree node, std::vector<data_value_t> &dvalues,
 }
 
 void
-print_call_name (tree node, std::vector<data_value_t> &dvalues,
+print_call_name (tree node, extract_vector<data_value_t> &dvalues,
                  data_value_t &dvalue)
 {
     tree op0 = node;
@@ -1307,8 +2593,139 @@ op_symbol (const_tree op)
     return op_symbol_code (TREE_CODE (op));
 }
 
+static void dump_tree_data_values (tree node,
+                                   extract_vector<data_value_t> &dvalues);
+
+/* Types, declarations, constants and SSA names are shared nodes that show
+   up over and over in operands, args, locals and SSA names, so their values
+   are built once per function and every use refers to them through a
+   shared entry.  The description only depends on the node itself.  The
+   cache is not kept across functions since the garbage collector may
+   recycle tree addresses between passes; it goes with the function's data
+   instead, see take_tree_data_values_cache ().  */
+static tree_values_cache_t tree_data_values_cache;
+
+static bool
+is_cacheable_tree (tree node)
+{
+    if (node == NULL_TREE)
+        return false;
+
+    switch (TREE_CODE_CLASS (TREE_CODE (node)))
+        {
+        case tcc_type:
+        case tcc_declaration:
+        case tcc_constant:
+            return true;
+
+        default:
+            return TREE_CODE (node) == SSA_NAME
+                   || TREE_CODE (node) == IDENTIFIER_NODE;
+        }
+}
+
+void
+clear_tree_data_values_cache ()
+{
+    tree_data_values_cache.clear ();
+}
+
+/* Hand the cache over to the function's data, whose values point into it
+   until they are written.  */
+void
+take_tree_data_values_cache (tree_values_cache_t &cache)
+{
+    cache = std::move (tree_data_values_cache);
+    tree_data_values_cache.clear ();
+}
+
+/* Deep copy of SOURCE into DVALUES with every shared entry expanded, for
+   data that outlives the cache such as the unit type table.  */
+static void
+append_unshared_values (extract_vector<data_value_t> &dvalues,
+                        const extract_vector<data_value_t> &source)
+{
+    for (const data_value_t &dvalue : source)
+        {
+            if (dvalue.shared_values)
+                {
+                    append_unshared_values (dvalues, *dvalue.shared_values);
+                    continue;
+                }
+
+            data_value_t &v = append_value_header (dvalues, dvalue);
+            v.simple_data_value = dvalue.simple_data_value;
+            append_unshared_values (v.complex_data_values,
+                                    dvalue.complex_data_values);
+        }
+}
+
+/* With type_table enabled a type is described once per unit in
+   unit_type_table, and every use of it becomes a type_ref value carrying
+   its TYPE_UID.  */
+static void
+get_type_ref_value (tree node, extract_vector<data_value_t> &dvalues)
+{
+    int type_id = TYPE_UID (node);
+
+    if (unit_type_table.find (type_id) == unit_type_table.end ())
+        {
+            // insert first so that self-referencing types terminate
+            tree_value_t &tvalue = unit_type_table[type_id];
+
+            // the table outlives the function arena
+            extract_arena_suspend heap_allocation;
+
+            extract_vector<data_value_t> type_dvalues;
+            dump_tree_data_values (node, type_dvalues);
+            tvalue.values = std::move (type_dvalues);
+        }
+
+    data_value_t dvalue;
+    get_basic_tree_node_info (node, dvalue);
+    dvalue.value_type = DATA_VALUE_TYPE_REF;
+    dvalue.type_id = type_id;
+    dvalues.push_back (std::move (dvalue));
+}
+
 void
-get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
+get_tree_data_values (tree node, extract_vector<data_value_t> &dvalues)
+{
+    if (config_type_table && node != NULL_TREE && TYPE_P (node))
+        {
+            get_type_ref_value (node, dvalues);
+            return;
+        }
+
+    if (!is_cacheable_tree (node))
+        {
+            dump_tree_data_values (node, dvalues);
+            return;
+        }
+
+    auto it = tree_data_values_cache.find (node);
+    if (it == tree_data_values_cache.end ())
+        {
+            extract_vector<data_value_t> node_dvalues;
+            dump_tree_data_values (node, node_dvalues);
+
+            it = tree_data_values_cache.emplace (node, std::move (node_dvalues))
+                     .first;
+        }
+
+    // heap allocations (the type table) must not point into the cache
+    if (!current_extract_arena || current_extract_arena->suspended)
+        {
+            append_unshared_values (dvalues, it->second);
+            return;
+        }
+
+    dvalues.emplace_back ();
+    dvalues.back ().shared_values = &it->second;
+}
+
+static void
+dump_tree_data_values (tree node, extract_vector<data_value_t> &dvalues)
 {
     data_value_t dvalue;
     get_basic_tree_node_info (node, dvalue);
@@ -1337,7 +2754,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case TREE_LIST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 while (node && node != error_mark_node)
                     {
@@ -1364,7 +2781,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case TREE_BINFO:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 get_tree_data_values (BINFO_TYPE (node), complex_dvalues);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -1372,7 +2789,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case TREE_VEC:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 size_t i;
                 if (TREE_VEC_LENGTH (node) > 0)
@@ -1402,7 +2819,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case ENUMERAL_TYPE:
         case BOOLEAN_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 unsigned int quals = TYPE_QUALS (node);
                 enum tree_code_class tclass;
@@ -1588,7 +3005,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case POINTER_TYPE:
         case REFERENCE_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 const char *str
                     = (TREE_CODE (node) == POINTER_TYPE ? "*" : "&");
 
@@ -1658,7 +3075,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case OFFSET_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 do_niy (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -1667,7 +3084,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case MEM_REF:
         case TARGET_MEM_REF:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 dump_mem_ref (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -1675,7 +3092,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case ARRAY_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 unsigned int quals = TYPE_QUALS (node);
                 tree tmp;
 
@@ -1712,7 +3129,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case UNION_TYPE:
         case QUAL_UNION_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 unsigned int quals = TYPE_QUALS (node);
 
                 if (quals & TYPE_QUAL_ATOMIC)
@@ -1758,7 +3175,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case LANG_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 do_niy (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -1766,7 +3183,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case INTEGER_CST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if ((POINTER_TYPE_P (TREE_TYPE (node))
                      || (TYPE_PRECISION (TREE_TYPE (node))
@@ -1871,7 +3288,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case POLY_INT_CST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "POLY_INT_CST [");
                 get_tree_data_values (POLY_INT_CST_COEFF (node, 0),
@@ -1891,7 +3308,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case REAL_CST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 /* Code copied from print_node.  */
 
@@ -1933,7 +3350,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case COMPLEX_CST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "__complex__ (");
                 get_tree_data_values (TREE_REALPART (node), complex_dvalues);
@@ -1949,7 +3366,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case STRING_CST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "\"");
                 if (unsigned nbytes = TREE_STRING_LENGTH (node))
@@ -1966,7 +3383,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case VECTOR_CST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 unsigned i;
                 ppp_string (complex_dvalues, dvalue, "_Literal (");
@@ -2001,7 +3418,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case FUNCTION_TYPE:
         case METHOD_TYPE:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 get_tree_data_values (TREE_TYPE (node), complex_dvalues);
                 ppp_space (complex_dvalues, dvalue);
@@ -2045,7 +3462,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case FUNCTION_DECL:
         case CONST_DECL:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 dump_decl_name (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -2053,7 +3470,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case LABEL_DECL:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (DECL_NAME (node))
                     {
@@ -2078,7 +3495,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case TYPE_DECL:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (DECL_IS_UNDECLARED_BUILTIN (node))
                     {
@@ -2110,7 +3527,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case NAMESPACE_DECL:
         case NAMELIST_DECL:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 dump_decl_name (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -2118,7 +3535,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case RESULT_DECL:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 ppp_string (complex_dvalues, dvalue, "<retval>");
                 dump_decl_name (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
@@ -2127,7 +3544,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case COMPONENT_REF:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 tree op0 = TREE_OPERAND (node, 0);
                 std::string str = ".";
@@ -2194,7 +3611,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case BIT_FIELD_REF:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 ppp_string (complex_dvalues, dvalue, "BIT_FIELD_REF <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
                 ppp_string (complex_dvalues, dvalue, ", ");
@@ -2208,7 +3625,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case BIT_INSERT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "BIT_INSERT_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2238,7 +3655,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case ARRAY_REF:
         case ARRAY_RANGE_REF:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 tree op0 = TREE_OPERAND (node, 0);
                 if (op_prio (op0) < op_prio (node))
@@ -2278,7 +3695,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case CONSTRUCTOR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 unsigned HOST_WIDE_INT ix;
                 tree field, val;
@@ -2398,7 +3815,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case COMPOUND_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 tree *tp;
 
@@ -2426,7 +3843,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case STATEMENT_LIST:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 tree_stmt_iterator si;
                 // bool first = true;
 
@@ -2446,7 +3863,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case MODIFY_EXPR:
         case INIT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
                 ppp_space (complex_dvalues, dvalue);
@@ -2460,7 +3877,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case TARGET_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "TARGET_EXPR <");
                 get_tree_data_values (TARGET_EXPR_SLOT (node), complex_dvalues);
@@ -2476,7 +3893,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case DECL_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 print_declaration (DECL_EXPR_DECL (node), complex_dvalues,
                                    dvalue);
@@ -2487,7 +3904,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case COND_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (TREE_TYPE (node) == NULL
                     || TREE_TYPE (node) == void_type_node)
@@ -2575,7 +3992,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case BIND_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_left_brace (complex_dvalues, dvalue);
 
@@ -2603,7 +4020,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case CALL_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (CALL_EXPR_FN (node) != NULL_TREE)
                     print_call_name (CALL_EXPR_FN (node), complex_dvalues,
@@ -2664,7 +4081,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case WITH_CLEANUP_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 do_niy (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -2672,7 +4089,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case CLEANUP_POINT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "<<cleanup_point ");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2684,7 +4101,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case PLACEHOLDER_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "<PLACEHOLDER_EXPR ");
                 get_tree_data_values (TREE_TYPE (node), complex_dvalues);
@@ -2743,7 +4160,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case ORDERED_EXPR:
         case UNORDERED_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 const char *op = op_symbol (node);
                 tree op0 = TREE_OPERAND (node, 0);
@@ -2791,7 +4208,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case PREINCREMENT_EXPR:
         case INDIRECT_REF:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (TREE_CODE (node) == ADDR_EXPR
                     && (TREE_CODE (TREE_OPERAND (node, 0)) == STRING_CST
@@ -2822,7 +4239,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case POSTDECREMENT_EXPR:
         case POSTINCREMENT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (op_prio (TREE_OPERAND (node, 0)) < op_prio (node))
                     {
@@ -2844,7 +4261,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case MIN_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "MIN_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2858,7 +4275,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case MAX_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "MAX_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2872,7 +4289,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case ABS_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "ABS_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2884,7 +4301,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case ABSU_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "ABSU_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2896,7 +4313,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case RANGE_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
                 do_niy (node, complex_dvalues, dvalue);
                 append_complex_value (dvalues, dvalue, complex_dvalues);
                 break;
@@ -2908,7 +4325,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case FLOAT_EXPR:
         CASE_CONVERT:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 tree type = TREE_TYPE (node);
                 tree op0 = TREE_OPERAND (node, 0);
@@ -2934,7 +4351,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case VIEW_CONVERT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "VIEW_CONVERT_EXPR<");
 
@@ -2949,7 +4366,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case PAREN_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "((");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2961,7 +4378,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case NON_LVALUE_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "NON_LVALUE_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2973,7 +4390,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case SAVE_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "SAVE_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2985,7 +4402,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case COMPLEX_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "COMPLEX_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -2999,7 +4416,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case CONJ_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "CONJ_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3011,7 +4428,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case REALPART_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "REALPART_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3023,7 +4440,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case IMAGPART_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "IMAGPART_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3035,7 +4452,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case VA_ARG_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "VA_ARG_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3048,7 +4465,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         case TRY_FINALLY_EXPR:
             
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "try");
                 // newline_and_indent(pp, spc + 2);
@@ -3096,7 +4513,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case CATCH_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "catch (");
                 get_tree_data_values (CATCH_TYPES (node), complex_dvalues);
@@ -3114,7 +4531,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case EH_FILTER_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "<<<eh_filter (");
                 get_tree_data_values (EH_FILTER_TYPES (node), complex_dvalues);
@@ -3133,7 +4550,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case LABEL_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 tree op0 = TREE_OPERAND (node, 0);
                 /* If this is for break or continue, don't bother printing it.
@@ -3160,7 +4577,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case LOOP_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "while (1)");
 
@@ -3177,7 +4594,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case PREDICT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "// predicted ");
                 if (PREDICT_EXPR_OUTCOME (node))
@@ -3198,7 +4615,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case ANNOTATE_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "ANNOTATE_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3235,7 +4652,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case RETURN_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "return");
                 tree op0 = TREE_OPERAND (node, 0);
@@ -3259,7 +4676,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case EXIT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "if (");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3271,7 +4688,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case SWITCH_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "switch (");
                 get_tree_data_values (SWITCH_COND (node), complex_dvalues);
@@ -3294,7 +4711,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case GOTO_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 tree op0 = GOTO_DESTINATION (node);
                 if (TREE_CODE (op0) != SSA_NAME && DECL_P (op0)
@@ -3317,7 +4734,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case ASM_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "__asm__");
                 if (ASM_VOLATILE_P (node))
@@ -3344,7 +4761,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case CASE_LABEL_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (CASE_LOW (node) && CASE_HIGH (node))
                     {
@@ -3371,7 +4788,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case OBJ_TYPE_REF:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "OBJ_TYPE_REF(");
                 get_tree_data_values (OBJ_TYPE_REF_EXPR (node),
@@ -3404,7 +4821,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case SSA_NAME:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 if (SSA_NAME_IDENTIFIER (node))
                     {
@@ -3442,7 +4859,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case WITH_SIZE_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "WITH_SIZE_EXPR <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3459,7 +4876,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         #else
         case ASSERT_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "ASSERT_EXPR <");
                 get_tree_data_values (ASSERT_EXPR_VAR (node), complex_dvalues);
@@ -3487,7 +4904,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case POLYNOMIAL_CHREC:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_left_brace (complex_dvalues, dvalue);
                 get_tree_data_values (CHREC_LEFT (node), complex_dvalues);
@@ -3502,7 +4919,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case REALIGN_LOAD_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, "REALIGN_LOAD <");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3518,7 +4935,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case VEC_COND_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, " VEC_COND_EXPR < ");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3534,7 +4951,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case VEC_PERM_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, " VEC_PERM_EXPR < ");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3550,7 +4967,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case DOT_PROD_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue, " DOT_PROD_EXPR < ");
                 get_tree_data_values (TREE_OPERAND (node, 0), complex_dvalues);
@@ -3566,7 +4983,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case WIDEN_MULT_PLUS_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue,
                             " WIDEN_MULT_PLUS_EXPR < ");
@@ -3583,7 +5000,7 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
 
         case WIDEN_MULT_MINUS_EXPR:
             {
-                std::vector<data_value_t> complex_dvalues;
+                extract_vector<data_value_t> complex_dvalues;
 
                 ppp_string (complex_dvalues, dvalue,
                             " WIDEN_MULT_MINUS_EXPR < ");
@@ -3601,7 +5018,8 @@ get_tree_data_values (tree node, std::vector<data_value_t> &dvalues)
         default:
             {
                 append_simple_value (dvalues, dvalue,
-                                     "<<< Unknown tree: " + dvalue.code_name
+                                     "<<< Unknown tree: "
+                                         + std::string (dvalue.code_name)
                                          + " >>");
                 break;
             }
@@ -3616,14 +5034,14 @@ get_gimple_mem_ops (const gimple *gs, gimple_stmt_data &stmt_data)
 
     if (vdef != NULL_TREE)
         {
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             data_value_t dvalue;
             get_basic_tree_node_info (vdef, dvalue);
 
             ppp_string (dvalues, dvalue, "# ");
 
-            std::vector<data_value_t> vdef_complex_dvalues;
+            extract_vector<data_value_t> vdef_complex_dvalues;
             get_tree_data_values (vdef, vdef_complex_dvalues);
             append_complex_value (dvalues, dvalue, vdef_complex_dvalues);
 
@@ -3632,38 +5050,38 @@ get_gimple_mem_ops (const gimple *gs, gimple_stmt_data &stmt_data)
             data_value_t dvalue_vuse;
             get_basic_tree_node_info (vdef, dvalue_vuse);
 
-            std::vector<data_value_t> vuse_complex_dvalues;
+            extract_vector<data_value_t> vuse_complex_dvalues;
             get_tree_data_values (vuse, vuse_complex_dvalues);
             append_complex_value (dvalues, dvalue_vuse, vuse_complex_dvalues);
 
             ppp_greater (dvalues, dvalue);
 
-            tree_value_t tvalue{ .values = dvalues };
-            stmt_data.vdef_value = tvalue;
+            tree_value_t tvalue{ .values = std::move (dvalues) };
+            stmt_data.vdef_value = std::move (tvalue);
         }
 
     else if (vuse != NULL_TREE)
         {
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             data_value_t dvalue;
             get_basic_tree_node_info (vuse, dvalue);
 
             ppp_string (dvalues, dvalue, "# VUSE <");
 
-            std::vector<data_value_t> vuse_complex_dvalues;
+            extract_vector<data_value_t> vuse_complex_dvalues;
             get_tree_data_values (vuse, vuse_complex_dvalues);
             append_complex_value (dvalues, dvalue, vuse_complex_dvalues);
 
             ppp_greater (dvalues, dvalue);
 
-            tree_value_t tvalue{ .values = dvalues };
-            stmt_data.vuse_value = tvalue;
+            tree_value_t tvalue{ .values = std::move (dvalues) };
+            stmt_data.vuse_value = std::move (tvalue);
         }
 }
 
 static void
-dump_gimple_call_args (const gcall *gs, gimple_stmt_data &stmt_data)
+dump_gimple_call_args (const gcall *gs, gimple_call_data_t &call_data)
 {
     size_t i = 0;
 
@@ -3728,14 +5146,14 @@ dump_gimple_call_args (const gcall *gs, gimple_stmt_data &stmt_data)
 
                             tree_value_t tvalue;
                             data_value_t dvalue;
-                            std::vector<data_value_t> dvalues;
+                            extract_vector<data_value_t> dvalues;
 
                             get_basic_tree_node_info (arg0, dvalue);
                             append_simple_value (dvalues, dvalue, enums[v]);
 
-                            dvalues.push_back (dvalue);
-                            tvalue.values = dvalues;
-                            stmt_data.gcall_args.push_back (tvalue);
+                            dvalues.push_back (std::move (dvalue));
+                            tvalue.values = std::move (dvalues);
+                            call_data.gcall_args.push_back (std::move (tvalue));
 
                             // pp_string(buffer, enums[v]);
                         }
@@ -3747,12 +5165,12 @@ dump_gimple_call_args (const gcall *gs, gimple_stmt_data &stmt_data)
             // if (i) pp_string(buffer, ", ");
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (gimple_call_arg (gs, i), dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gcall_args.push_back (tvalue);
+            tvalue.values = std::move (dvalues);
+            call_data.gcall_args.push_back (std::move (tvalue));
         }
 
     if (gimple_call_va_arg_pack_p ((gcall*)gs))
@@ -3815,12 +5233,6 @@ gimple_tuple_arg_values (gimple *g, gimple_stmt_data &stmt_data)
                 break;
             }
 
-        case GIMPLE_NOP:
-            {
-                stmt_data.gnop_nop_str = "GIMPLE_NOP";
-                break;
-            }
-
         case GIMPLE_RETURN:
             {
                 const greturn *gs = reinterpret_cast<const greturn *> (g);
@@ -3858,19 +5270,21 @@ gimple_tuple_arg_values (gimple *g, gimple_stmt_data &stmt_data)
 void
 dump_gimple_asm (const gasm *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_asm_data_t &asm_data = stmt_data.data<gimple_asm_data_t> ();
+
     unsigned int i, n;
-    stmt_data.gasm_string_code = gimple_asm_string (gs);
+    asm_data.gasm_string_code = gimple_asm_string (gs);
 
     if (gimple_asm_volatile_p (gs))
         {
             // pp_string("__volatile__");
-            stmt_data.gasm_volatile = true;
+            asm_data.gasm_volatile = true;
         }
 
     if (gimple_asm_inline_p (gs))
         {
             // pp_string(" __inline__");
-            stmt_data.gasm_inline = true;
+            asm_data.gasm_inline = true;
         }
 
     // Return the number of output operands for GIMPLE_ASM G
@@ -3880,13 +5294,13 @@ dump_gimple_asm (const gasm *gs, gimple_stmt_data &stmt_data)
             for (i = 0; i < n; i++)
                 {
                     tree_value_t tvalue;
-                    std::vector<data_value_t> dvalues;
+                    extract_vector<data_value_t> dvalues;
 
                     get_tree_data_values (gimple_asm_output_op (gs, i),
                                           dvalues);
 
-                    tvalue.values = dvalues;
-                    stmt_data.gasm_output_operands.push_back (tvalue);
+                    tvalue.values = std::move (dvalues);
+                    asm_data.gasm_output_operands.push_back (std::move (tvalue));
                 }
         }
 
@@ -3897,12 +5311,12 @@ dump_gimple_asm (const gasm *gs, gimple_stmt_data &stmt_data)
             for (i = 0; i < n; i++)
                 {
                     tree_value_t tvalue;
-                    std::vector<data_value_t> dvalues;
+                    extract_vector<data_value_t> dvalues;
 
                     get_tree_data_values (gimple_asm_input_op (gs, i), dvalues);
 
-                    tvalue.values = dvalues;
-                    stmt_data.gasm_input_operands.push_back (tvalue);
+                    tvalue.values = std::move (dvalues);
+                    asm_data.gasm_input_operands.push_back (std::move (tvalue));
                 }
         }
 
@@ -3913,13 +5327,13 @@ dump_gimple_asm (const gasm *gs, gimple_stmt_data &stmt_data)
             for (i = 0; i < n; i++)
                 {
                     tree_value_t tvalue;
-                    std::vector<data_value_t> dvalues;
+                    extract_vector<data_value_t> dvalues;
 
                     get_tree_data_values (gimple_asm_clobber_op (gs, i),
                                           dvalues);
 
-                    tvalue.values = dvalues;
-                    stmt_data.gasm_clobber_operands.push_back (tvalue);
+                    tvalue.values = std::move (dvalues);
+                    asm_data.gasm_clobber_operands.push_back (std::move (tvalue));
                 }
         }
 
@@ -3929,12 +5343,12 @@ dump_gimple_asm (const gasm *gs, gimple_stmt_data &stmt_data)
             for (i = 0; i < n; i++)
                 {
                     tree_value_t tvalue;
-                    std::vector<data_value_t> dvalues;
+                    extract_vector<data_value_t> dvalues;
 
                     get_tree_data_values (gimple_asm_label_op (gs, i), dvalues);
 
-                    tvalue.values = dvalues;
-                    stmt_data.gasm_labels.push_back (tvalue);
+                    tvalue.values = std::move (dvalues);
+                    asm_data.gasm_labels.push_back (std::move (tvalue));
                 }
         }
 }
@@ -3942,6 +5356,8 @@ dump_gimple_asm (const gasm *gs, gimple_stmt_data &stmt_data)
 void
 dump_gimple_assign (const gassign *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_assign_data_t &assign_data = stmt_data.data<gimple_assign_data_t> ();
+
     tree arg1 = NULL;
     tree arg2 = NULL;
     tree arg3 = NULL;
@@ -3961,75 +5377,77 @@ dump_gimple_assign (const gassign *gs, gimple_stmt_data &stmt_data)
             gcc_unreachable ();
         }
 
-    stmt_data.gassign_subcode
+    assign_data.gassign_subcode
         = get_tree_code_name (gimple_assign_rhs_code (gs));
 
     if (arg1 != NULL)
         {
-            stmt_data.gassign_has_rhs_arg1 = true;
+            assign_data.gassign_has_rhs_arg1 = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (arg1, dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gassign_rhs_arg1 = tvalue;
+            tvalue.values = std::move (dvalues);
+            assign_data.gassign_rhs_arg1 = std::move (tvalue);
         }
 
     if (arg2 != NULL)
         {
-            stmt_data.gassign_has_rhs_arg2 = true;
+            assign_data.gassign_has_rhs_arg2 = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (arg2, dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gassign_rhs_arg2 = tvalue;
+            tvalue.values = std::move (dvalues);
+            assign_data.gassign_rhs_arg2 = std::move (tvalue);
         }
 
     if (arg3 != NULL)
         {
-            stmt_data.gassign_has_rhs_arg2 = true;
+            assign_data.gassign_has_rhs_arg2 = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (arg3, dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gassign_rhs_arg3 = tvalue;
+            tvalue.values = std::move (dvalues);
+            assign_data.gassign_rhs_arg3 = std::move (tvalue);
         }
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (gimple_assign_lhs (gs), dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.gassign_lhs_arg = tvalue;
+        tvalue.values = std::move (dvalues);
+        assign_data.gassign_lhs_arg = std::move (tvalue);
     }
 }
 
 void
 dump_gimple_bind (const gbind *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_bind_data_t &bind_data = stmt_data.data<gimple_bind_data_t> ();
+
     tree var;
 
     for (var = gimple_bind_vars (gs); var; var = DECL_CHAIN (var))
         {
             tree_value_t tvalue;
             data_value_t dvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_basic_tree_node_info (var, dvalue);
             print_declaration (var, dvalues, dvalue);
 
-            tvalue.values = dvalues;
-            stmt_data.gbind_bind_vars.push_back (tvalue);
+            tvalue.values = std::move (dvalues);
+            bind_data.gbind_bind_vars.push_back (std::move (tvalue));
         }
 
     gimple_seq seq = gimple_bind_body ((gbind*)gs);
@@ -4041,79 +5459,81 @@ dump_gimple_bind (const gbind *gs, gimple_stmt_data &stmt_data)
             gimple_stmt_data stmt_data_tmp = gimple_tuple_to_stmt_data (
                 (gimple *)gs, stmt_data.basic_block_index,
                 stmt_data.basic_block_edges);
-            stmt_data.gbind_bind_body.push_back (stmt_data_tmp);
+            bind_data.gbind_bind_body.push_back (std::move (stmt_data_tmp));
         }
 }
 
 void
 dump_gimple_call (const gcall *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_call_data_t &call_data = stmt_data.data<gimple_call_data_t> ();
+
     tree lhs = gimple_call_lhs (gs);
     tree fn = gimple_call_fn (gs);
 
     if (gimple_call_internal_p (gs))
         {
-            stmt_data.gcall_isinternal_only_function = true;
-            stmt_data.gcall_internal_function_name
+            call_data.gcall_isinternal_only_function = true;
+            call_data.gcall_internal_function_name
                 = internal_fn_name (gimple_call_internal_fn (gs));
         }
 
     if (fn)
         {
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (fn, dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gcall_fn = tvalue;
+            tvalue.values = std::move (dvalues);
+            call_data.gcall_fn = std::move (tvalue);
         }
 
     if (lhs)
         {
-            stmt_data.gcall_has_lhs = true;
+            call_data.gcall_has_lhs = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (lhs, dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gcall_lhs_arg = tvalue;
+            tvalue.values = std::move (dvalues);
+            call_data.gcall_lhs_arg = std::move (tvalue);
         }
 
-    stmt_data.gcall_call_num_of_args = gimple_call_num_args (gs);
-    if (stmt_data.gcall_call_num_of_args > 0)
+    call_data.gcall_call_num_of_args = gimple_call_num_args (gs);
+    if (call_data.gcall_call_num_of_args > 0)
         {
-            dump_gimple_call_args (gs, stmt_data);
+            dump_gimple_call_args (gs, call_data);
         }
 
     if (gimple_call_chain (gs))
         {
-            stmt_data.gcall_has_static_chain_for_call_statement = true;
+            call_data.gcall_has_static_chain_for_call_statement = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (gimple_call_chain (gs), dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gcall_static_chain_for_call_statement = tvalue;
+            tvalue.values = std::move (dvalues);
+            call_data.gcall_static_chain_for_call_statement = std::move (tvalue);
         }
 
     if (gimple_call_return_slot_opt_p ((gcall*)gs))
         {
-            stmt_data.gcall_is_marked_for_return_slot_optimization = true;
+            call_data.gcall_is_marked_for_return_slot_optimization = true;
         }
 
     if (gimple_call_tail_p ((gcall*)gs))
         {
-            stmt_data.gcall_is_marked_as_a_tail_call = true;
+            call_data.gcall_is_marked_as_a_tail_call = true;
         }
 
     if (gimple_call_must_tail_p (gs))
         {
-            stmt_data.gcall_is_marked_as_requiring_tail_call_optimization
+            call_data.gcall_is_marked_as_requiring_tail_call_optimization
                 = true;
         }
 
@@ -4129,7 +5549,7 @@ dump_gimple_call (const gcall *gs, gimple_stmt_data &stmt_data)
     if (TREE_CODE (fn) == FUNCTION_DECL && decl_is_tm_clone (fn))
         {
             // pp_string(buffer, " [tm-clone]");
-            stmt_data.gcall_is_tm_clone = true;
+            call_data.gcall_is_tm_clone = true;
         }
 
     if (TREE_CODE (fn) == FUNCTION_DECL
@@ -4145,72 +5565,72 @@ dump_gimple_call (const gcall *gs, gimple_stmt_data &stmt_data)
 
             if (props & PR_INSTRUMENTEDCODE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "instrumentedCode");
                 }
             if (props & PR_UNINSTRUMENTEDCODE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "uninstrumentedCode");
                 }
             if (props & PR_HASNOXMMUPDATE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "hasNoXMMUpdate");
                 }
             if (props & PR_HASNOABORT)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "hasNoAbort");
                 }
             if (props & PR_HASNOIRREVOCABLE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "hasNoIrrevocable");
                 }
             if (props & PR_DOESGOIRREVOCABLE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "doesGoIrrevocable");
                 }
             if (props & PR_HASNOSIMPLEREADS)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "hasNoSimpleReads");
                 }
             if (props & PR_AWBARRIERSOMITTED)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "awBarriersOmitted");
                 }
             if (props & PR_RARBARRIERSOMITTED)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "RaRBarriersOmitted");
                 }
             if (props & PR_UNDOLOGCODE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "undoLogCode");
                 }
             if (props & PR_PREFERUNINSTRUMENTED)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "preferUninstrumented");
                 }
             if (props & PR_EXCEPTIONBLOCK)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "exceptionBlock");
                 }
             if (props & PR_HASELSE)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "hasElse");
                 }
             if (props & PR_READONLY)
                 {
-                    stmt_data.gcall_transaction_code_properties.push_back (
+                    call_data.gcall_transaction_code_properties.push_back (
                         "readOnly");
                 }
         }
@@ -4325,52 +5745,54 @@ dump_gimple_call (const gcall *gs, gimple_stmt_data &stmt_data)
 void
 dump_gimple_cond (const gcond *gs, gimple_stmt_data &stmt_data)
 {
-    stmt_data.gcond_tree_code_name = get_tree_code_name (gimple_cond_code (gs));
+    gimple_cond_data_t &cond_data = stmt_data.data<gimple_cond_data_t> ();
+
+    cond_data.gcond_tree_code_name = get_tree_code_name (gimple_cond_code (gs));
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (gimple_cond_lhs (gs), dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.gcond_lhs = tvalue;
+        tvalue.values = std::move (dvalues);
+        cond_data.gcond_lhs = std::move (tvalue);
     }
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (gimple_cond_rhs (gs), dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.gcond_rhs = tvalue;
+        tvalue.values = std::move (dvalues);
+        cond_data.gcond_rhs = std::move (tvalue);
     }
 
     if (gimple_cond_true_label (gs))
         {
-            stmt_data.gcond_has_true_goto_label = true;
+            cond_data.gcond_has_true_goto_label = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (gimple_cond_true_label (gs), dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gcond_true_goto_label = tvalue;
+            tvalue.values = std::move (dvalues);
+            cond_data.gcond_true_goto_label = std::move (tvalue);
         }
 
     if (gimple_cond_false_label (gs))
         {
-            stmt_data.gcond_has_false_else_goto_label = true;
+            cond_data.gcond_has_false_else_goto_label = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (gimple_cond_false_label (gs), dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gcond_false_else_goto_label = tvalue;
+            tvalue.values = std::move (dvalues);
+            cond_data.gcond_false_else_goto_label = std::move (tvalue);
         }
 
     edge_iterator ei;
@@ -4389,16 +5811,16 @@ dump_gimple_cond (const gcond *gs, gimple_stmt_data &stmt_data)
 
             if (true_edge != NULL)
                 {
-                    stmt_data.gcond_has_goto_true_edge = true;
+                    cond_data.gcond_has_goto_true_edge = true;
                     basic_block tmp_bb = true_edge->dest;
-                    stmt_data.goto_true_edge = tmp_bb->index;
+                    cond_data.goto_true_edge = tmp_bb->index;
                 }
 
             if (false_edge != NULL)
                 {
-                    stmt_data.gcond_has_else_goto_false_edge = true;
+                    cond_data.gcond_has_else_goto_false_edge = true;
                     basic_block tmp_bb = false_edge->dest;
-                    stmt_data.else_goto_false_edge = tmp_bb->index;
+                    cond_data.else_goto_false_edge = tmp_bb->index;
                 }
         }
 }
@@ -4406,74 +5828,82 @@ dump_gimple_cond (const gcond *gs, gimple_stmt_data &stmt_data)
 void
 dump_gimple_label (const glabel *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_label_data_t &label_data = stmt_data.data<gimple_label_data_t> ();
+
     tree label = gimple_label_label (gs);
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (label, dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.glabel_label = tvalue;
+        tvalue.values = std::move (dvalues);
+        label_data.glabel_label = std::move (tvalue);
     }
 
     if (DECL_NONLOCAL (label))
         {
-            stmt_data.glabel_is_non_local = true;
+            label_data.glabel_is_non_local = true;
         }
 }
 
 void
 dump_gimple_goto (const ggoto *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_goto_data_t &goto_data = stmt_data.data<gimple_goto_data_t> ();
+
     tree label = gimple_goto_dest (gs);
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (label, dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.ggoto_dest_goto_label = tvalue;
+        tvalue.values = std::move (dvalues);
+        goto_data.ggoto_dest_goto_label = std::move (tvalue);
     }
 }
 
 void
 dump_gimple_return (const greturn *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_return_data_t &return_data = stmt_data.data<gimple_return_data_t> ();
+
     tree t;
     t = gimple_return_retval (gs);
 
     if (t)
         {
-            stmt_data.greturn_has_greturn_return_value = true;
+            return_data.greturn_has_greturn_return_value = true;
 
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (t, dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.greturn_return_value = tvalue;
+            tvalue.values = std::move (dvalues);
+            return_data.greturn_return_value = std::move (tvalue);
         }
 }
 
 void
 dump_gimple_switch (const gswitch *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_switch_data_t &switch_data = stmt_data.data<gimple_switch_data_t> ();
+
     unsigned int i;
     GIMPLE_CHECK (gs, GIMPLE_SWITCH);
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (gimple_switch_index (gs), dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.gswitch_switch_index = tvalue;
+        tvalue.values = std::move (dvalues);
+        switch_data.gswitch_switch_index = std::move (tvalue);
     }
 
     for (i = 0; i < gimple_switch_num_labels (gs); i++)
@@ -4481,23 +5911,23 @@ dump_gimple_switch (const gswitch *gs, gimple_stmt_data &stmt_data)
             tree case_label = gimple_switch_label (gs, i);
             {
                 tree_value_t tvalue;
-                std::vector<data_value_t> dvalues;
+                extract_vector<data_value_t> dvalues;
 
                 get_tree_data_values (case_label, dvalues);
 
-                tvalue.values = dvalues;
-                stmt_data.gswitch_switch_case_labels.push_back (tvalue);
+                tvalue.values = std::move (dvalues);
+                switch_data.gswitch_switch_case_labels.push_back (std::move (tvalue));
             }
 
             tree label = CASE_LABEL (case_label);
             {
                 tree_value_t tvalue;
-                std::vector<data_value_t> dvalues;
+                extract_vector<data_value_t> dvalues;
 
                 get_tree_data_values (label, dvalues);
 
-                tvalue.values = dvalues;
-                stmt_data.gswitch_switch_labels.push_back (tvalue);
+                tvalue.values = std::move (dvalues);
+                switch_data.gswitch_switch_labels.push_back (std::move (tvalue));
             }
         }
 }
@@ -4505,14 +5935,16 @@ dump_gimple_switch (const gswitch *gs, gimple_stmt_data &stmt_data)
 void
 dump_gimple_try (const gtry *gs, gimple_stmt_data &stmt_data)
 {
+    gimple_try_data_t &try_data = stmt_data.data<gimple_try_data_t> ();
+
     if (gimple_try_kind (gs) == GIMPLE_TRY_CATCH)
         {
-            stmt_data.gtry_try_type_kind = "GIMPLE_TRY_CATCH";
+            try_data.gtry_try_type_kind = "GIMPLE_TRY_CATCH";
         }
 
     if (gimple_try_kind (gs) == GIMPLE_TRY_FINALLY)
         {
-            stmt_data.gtry_try_type_kind = "GIMPLE_TRY_FINALLY";
+            try_data.gtry_try_type_kind = "GIMPLE_TRY_FINALLY";
         }
 
     {
@@ -4525,14 +5957,14 @@ dump_gimple_try (const gtry *gs, gimple_stmt_data &stmt_data)
                 gimple_stmt_data stmt_data_tmp = gimple_tuple_to_stmt_data (
                     gs, stmt_data.basic_block_index,
                     stmt_data.basic_block_edges);
-                stmt_data.gtry_try_eval.push_back (stmt_data_tmp);
+                try_data.gtry_try_eval.push_back (std::move (stmt_data_tmp));
             }
     }
 
     gimple_seq seq = gimple_try_cleanup ((gimple*)gs);
     if (seq)
         {
-            stmt_data.gtry_has_try_cleanup = true;
+            try_data.gtry_has_try_cleanup = true;
             gimple_stmt_iterator i;
 
             for (i = gsi_start (seq); !gsi_end_p (i); gsi_next (&i))
@@ -4541,7 +5973,7 @@ dump_gimple_try (const gtry *gs, gimple_stmt_data &stmt_data)
                     gimple_stmt_data stmt_data_tmp = gimple_tuple_to_stmt_data (
                         gs, stmt_data.basic_block_index,
                         stmt_data.basic_block_edges);
-                    stmt_data.gtry_try_cleanup.push_back (stmt_data_tmp);
+                    try_data.gtry_try_cleanup.push_back (std::move (stmt_data_tmp));
                 }
         }
 }
@@ -4549,31 +5981,33 @@ dump_gimple_try (const gtry *gs, gimple_stmt_data &stmt_data)
 void
 dump_gimple_phi (const gphi *phi, gimple_stmt_data &stmt_data)
 {
+    gimple_phi_data_t &phi_data = stmt_data.data<gimple_phi_data_t> ();
+
     size_t i;
     tree lhs = gimple_phi_result (phi);
 
     {
         tree_value_t tvalue;
-        std::vector<data_value_t> dvalues;
+        extract_vector<data_value_t> dvalues;
 
         get_tree_data_values (lhs, dvalues);
 
-        tvalue.values = dvalues;
-        stmt_data.gphi_lhs = tvalue;
+        tvalue.values = std::move (dvalues);
+        phi_data.gphi_lhs = std::move (tvalue);
     }
 
     for (i = 0; i < gimple_phi_num_args (phi); i++)
         {
             tree_value_t tvalue;
-            std::vector<data_value_t> dvalues;
+            extract_vector<data_value_t> dvalues;
 
             get_tree_data_values (gimple_phi_arg_def ((gphi*)phi, i), dvalues);
 
-            tvalue.values = dvalues;
-            stmt_data.gphi_phi_args.push_back (tvalue);
+            tvalue.values = std::move (dvalues);
+            phi_data.gphi_phi_args.push_back (std::move (tvalue));
 
             basic_block src = gimple_phi_arg_edge ((gphi*)phi, i)->src;
-            stmt_data.gphi_phi_args_basicblock_src_index.push_back (src->index);
+            phi_data.gphi_phi_args_basicblock_src_index.push_back (src->index);
 
             if (gimple_phi_arg_has_location ((gphi*)phi, i))
                 {
@@ -4585,11 +6019,11 @@ dump_gimple_phi (const gphi *phi, gimple_stmt_data &stmt_data)
                         loc_str = std::string (xloc.file) + ":"
                                   + std::to_string (xloc.line);
 
-                    stmt_data.gphi_phi_args_locations.push_back (loc_str);
+                    phi_data.gphi_phi_args_locations.push_back (loc_str);
                 }
             else
                 {
-                    stmt_data.gphi_phi_args_locations.push_back ("");
+                    phi_data.gphi_phi_args_locations.push_back ("");
                 }
         }
 }
@@ -5,8 +5,13 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <sstream>
 #include <iomanip>
+#include <utility>
+
+#include "extract_arena.h"
 
 #include "gcc-plugin.h"
 
@@ -51,7 +56,7 @@ typedef struct _gimple_stmt_data gimple_stmt_data;
 
 typedef struct _tree_value
 {
-    std::vector<data_value_t> values;
+    extract_vector<data_value_t> values;
 } tree_value_t;
 
 typedef struct fn_arg_variable
@@ -86,32 +91,114 @@ typedef struct _function_data
     int fn_end_line_no = -1;
     std::map<std::string, std::string> fn_source_lines;
     tree_value_t fn_decl;
-    std::vector<fn_arg_variable_t> fn_args;
-    std::vector<fn_local_variable_t> fn_local_variables;
-    std::vector<fn_ssa_variable_t> fn_ssa_variables;
-    std::vector<tree_value_t> fn_ssa_names;
+    extract_vector<fn_arg_variable_t> fn_args;
+    extract_vector<fn_local_variable_t> fn_local_variables;
+    extract_vector<fn_ssa_variable_t> fn_ssa_variables;
+    extract_vector<tree_value_t> fn_ssa_names;
+
+    // where the unit's type table is, the type_ids above index it
+    std::string fn_type_table;
 } function_data_t;
 
+// punctuation emitted by the ppp_* macros, see the compact encoding
+enum data_token
+{
+    DATA_TOKEN_NONE,
+    DATA_TOKEN_SPACE, // " "
+    DATA_TOKEN_LEFT_PAREN, // "("
+    DATA_TOKEN_RIGHT_PAREN, // ")"
+    DATA_TOKEN_LEFT_BRACKET, // "["
+    DATA_TOKEN_RIGHT_BRACKET, // "]"
+    DATA_TOKEN_LEFT_BRACE, // "{"
+    DATA_TOKEN_RIGHT_BRACE, // "}"
+    DATA_TOKEN_SEMICOLON, // ";"
+    DATA_TOKEN_COMMA, // ","
+    DATA_TOKEN_DOT, // "."
+    DATA_TOKEN_COLON, // ":"
+    DATA_TOKEN_COLON_COLON, // "::"
+    DATA_TOKEN_ARROW, // "->"
+    DATA_TOKEN_EQUAL, // "="
+    DATA_TOKEN_QUESTION, // "?"
+    DATA_TOKEN_BAR, // "|"
+    DATA_TOKEN_BAR_BAR, // "||"
+    DATA_TOKEN_CARRET, // "^"
+    DATA_TOKEN_AMPERSAND, // "&"
+    DATA_TOKEN_AMPERSAND_AMPERSAND, // "&&"
+    DATA_TOKEN_LESS, // "<"
+    DATA_TOKEN_LESS_EQUAL, // "<="
+    DATA_TOKEN_GREATER, // ">"
+    DATA_TOKEN_GREATER_EQUAL, // ">="
+    DATA_TOKEN_PLUS, // "+"
+    DATA_TOKEN_MINUS, // "-"
+    DATA_TOKEN_STAR, // "*"
+    DATA_TOKEN_SLASH, // "/"
+    DATA_TOKEN_MODULO, // "%"
+    DATA_TOKEN_EXCLAMATION, // "!"
+    DATA_TOKEN_COMPLEMENT, // "~"
+    DATA_TOKEN_QUOTE, // "'"
+    DATA_TOKEN_BACKQUOTE, // "`"
+    DATA_TOKEN_DOUBLEQUOTE, // "\""
+    DATA_TOKEN_UNDERSCORE, // "_"
+};
+
+enum data_value_type
+{
+    DATA_VALUE_SIMPLE,
+    DATA_VALUE_COMPLEX,
+    DATA_VALUE_TYPE_REF
+};
+
 typedef struct _data_value
 {
-    std::string value_type = "simple"; // simple|complex
+    enum data_value_type value_type = DATA_VALUE_SIMPLE;
 
+    // code_class and code_name point into GCC's static tree code tables
     enum tree_code code;
-    std::string code_class;
-    std::string code_name;
+    const char *code_class = "";
+    const char *code_name = "";
 
     bool is_expr = false;
     unsigned int operand_length = 0;
     bool has_inner_tree = false;
 
-    std::string location_file = "";
+    const char *location_file = "";
     int location_line = 0;
     int location_column = 0;
 
     std::string simple_data_value;
-    std::vector<data_value_t> complex_data_values;
+    extract_vector<data_value_t> complex_data_values;
+
+    // TYPE_UID of the referenced type when value_type is type_ref
+    int type_id = -1;
+
+    // set when the simple value is one of the ppp_* punctuation tokens
+    enum data_token token = DATA_TOKEN_NONE;
+
+    // when set, this entry stands for the cached values of a shared tree
+    // node and is written as those values, see get_tree_data_values ()
+    const extract_vector<data_value_t> *shared_values = nullptr;
 } data_value_t;
 
+typedef std::unordered_map<tree, extract_vector<data_value_t> >
+    tree_values_cache_t;
+
+typedef std::map<int, tree_value_t> type_table_t;
+
+/* A function or variable defined by the program, see
+   write_unit_symbol_table ().  */
+typedef struct _symbol_data
+{
+    std::string kind;
+    std::string name;
+    std::string asm_name;
+    std::string filename;
+    int line = 0;
+    bool is_public = false;
+    bool is_comdat = false;
+} symbol_data_t;
+
+typedef std::vector<symbol_data_t> symbol_table_t;
+
 typedef struct _gimple_phi_rhs
 {
     tree_value_t phi_rhs;
@@ -123,16 +210,54 @@ typedef struct _gimple_phi_rhs
 typedef struct _gimple_phi
 {
     tree_value_t phi_lhs;
-    std::vector<gimple_phi_rhs_t> gimple_phi_rhs_list;
+    extract_vector<gimple_phi_rhs_t> gimple_phi_rhs_list;
 } gimple_phi_t;
 
 typedef struct _basicblock
 {
     int bb_index = -1;
-    std::vector<int> bb_edges;
-    std::vector<gimple_phi_t> phis;
+    extract_vector<int> bb_edges;
+    extract_vector<gimple_phi_t> phis;
 } basicblock_t;
 
+/* Dominator tree, post-dominator tree and loop nesting of a function's
+   CFG, when config_cfg_info.  The bb_* arrays are indexed by basic block
+   index and the loop_* arrays by loop number, -1 where there is no such
+   block or loop (or no dominator, latch or outer loop).  Loop 0 is the
+   whole function; bb_loop is the innermost loop of a block.  Empty when
+   not computed.  */
+typedef struct _cfg_info
+{
+    extract_vector<int> bb_idom;
+    extract_vector<int> bb_ipdom;
+    extract_vector<int> bb_loop;
+    extract_vector<int> loop_header;
+    extract_vector<int> loop_latch;
+    extract_vector<int> loop_depth;
+    extract_vector<int> loop_outer;
+} cfg_info_t;
+
+/* Fields of a statement that depend on its GIMPLE code live in a payload
+   struct, so a statement only carries the data of its own kind.  Payloads
+   are allocated like the extraction containers (see extract_arena.h).  */
+struct gimple_stmt_payload
+{
+    virtual ~gimple_stmt_payload () {}
+
+    static void *
+    operator new (size_t size)
+    {
+        return extract_allocator<char> ().allocate (size);
+    }
+
+    static void
+    operator delete (void *ptr, size_t size)
+    {
+        extract_allocator<char> ().deallocate (static_cast<char *> (ptr),
+                                               size);
+    }
+};
+
 typedef struct _gimple_stmt_data
 {
     // std::string              function_name;
@@ -153,43 +278,91 @@ typedef struct _gimple_stmt_data
     unsigned int gimple_num_ops = 0;
 
     int basic_block_index = 0;
-    std::vector<int> basic_block_edges;
+    extract_vector<int> basic_block_edges;
 
-    std::vector<tree_value_t> tree_values;
+    extract_vector<tree_value_t> tree_values;
 
     tree_value_t vdef_value;
     tree_value_t vuse_value;
 
-    /**********************************************
-     * GIMPLE_ASM
-     *
-     * STRING is the assembly code.
-     * INPUTS, OUTPUTS, CLOBBERS and LABELS are the inputs, outputs, clobbered
-     * registers and labels.
-     *
-     * *******************************************/
+    // payload of gimple_stmt_code, see data ()
+    enum gimple_code payload_code = GIMPLE_NOP;
+    std::unique_ptr<gimple_stmt_payload> payload;
+
+    /* The per-code payload of type T (one of the gimple_*_data_t below),
+       created on first use.  */
+    template <typename T>
+    T &
+    data ()
+    {
+        if (!payload || payload_code != T::code)
+            {
+                payload.reset (new T);
+                payload_code = T::code;
+            }
+        return *static_cast<T *> (payload.get ());
+    }
+
+    /* The payload of type T, or null when there is none.  Unlike data ()
+       this never allocates, so it is safe on the writer threads.  */
+    template <typename T>
+    const T *
+    find () const
+    {
+        if (!payload || payload_code != T::code)
+            return nullptr;
+        return static_cast<const T *> (payload.get ());
+    }
+
+    template <typename T>
+    T *
+    find ()
+    {
+        if (!payload || payload_code != T::code)
+            return nullptr;
+        return static_cast<T *> (payload.get ());
+    }
+} gimple_stmt_data;
+
+/**********************************************
+ * GIMPLE_ASM
+ *
+ * STRING is the assembly code.
+ * INPUTS, OUTPUTS, CLOBBERS and LABELS are the inputs, outputs, clobbered
+ * registers and labels.
+ *
+ * *******************************************/
+typedef struct _gimple_asm_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_ASM;
+
     std::string gasm_string_code;
-    std::vector<tree_value_t> gasm_input_operands;
-    std::vector<tree_value_t> gasm_output_operands;
-    std::vector<tree_value_t> gasm_clobber_operands;
-    std::vector<tree_value_t> gasm_labels;
+    extract_vector<tree_value_t> gasm_input_operands;
+    extract_vector<tree_value_t> gasm_output_operands;
+    extract_vector<tree_value_t> gasm_clobber_operands;
+    extract_vector<tree_value_t> gasm_labels;
 
     bool gasm_volatile = false;
     bool gasm_inline = false;
+} gimple_asm_data_t;
+
+/**********************************************
+ * GIMPLE_ASSIGN
+ *
+ * The left-hand side is an lvalue passed in lhs
+ * The right-hand side can be either a unary or binary tree expression
+ * Subcode is the tree_code for the right-hand side of the assignment.
+ * Op1, op2 and op3 are the operands.
+ *
+ * "%G <%s, %T, %T, %T, %T>", gs,
+ * get_tree_code_name(gimple_assign_rhs_code(gs)), gimple_assign_lhs(gs),
+ * arg1, arg2, arg3
+ *
+ * *******************************************/
+typedef struct _gimple_assign_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_ASSIGN;
 
-    /**********************************************
-     * GIMPLE_ASSIGN
-     *
-     * The left-hand side is an lvalue passed in lhs
-     * The right-hand side can be either a unary or binary tree expression
-     * Subcode is the tree_code for the right-hand side of the assignment.
-     * Op1, op2 and op3 are the operands.
-     *
-     * "%G <%s, %T, %T, %T, %T>", gs,
-     * get_tree_code_name(gimple_assign_rhs_code(gs)), gimple_assign_lhs(gs),
-     * arg1, arg2, arg3
-     *
-     * *******************************************/
     std::string gassign_subcode;
 
     bool gassign_has_rhs_arg1 = false;
@@ -200,35 +373,45 @@ typedef struct _gimple_stmt_data
     tree_value_t gassign_rhs_arg1;
     tree_value_t gassign_rhs_arg2;
     tree_value_t gassign_rhs_arg3;
+} gimple_assign_data_t;
+
+/**********************************************
+ * GIMPLE_BIND
+ *
+ * The left-hand side is an lvalue passed in lhs
+ * The right-hand side can be either a unary or binary tree expression
+ * Subcode is the tree_code for the right-hand side of the assignment.
+ * Op1, op2 and op3 are the operands.
+ *
+ * "%G <", gs
+ *
+ * *******************************************/
+typedef struct _gimple_bind_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_BIND;
+
+    extract_vector<tree_value_t> gbind_bind_vars;
+
+    extract_vector<gimple_stmt_data> gbind_bind_body;
+} gimple_bind_data_t;
+
+/**********************************************
+ * GIMPLE_CALL
+ *
+ * Build a GIMPLE_CALL statement to function FN.
+ * The argument FN must be either a FUNCTION_DECL or a gimple call address
+ * as determined by is_gimple_call_addr. NARGS are the number of arguments.
+ * The rest of the arguments follow the argument NARGS, and must be trees
+ * that are valid as rvalues in gimple (i.e., each operand is validated with
+ * is_gimple_operand).
+ *
+ *
+ *
+ * *******************************************/
+typedef struct _gimple_call_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_CALL;
 
-    /**********************************************
-     * GIMPLE_BIND
-     *
-     * The left-hand side is an lvalue passed in lhs
-     * The right-hand side can be either a unary or binary tree expression
-     * Subcode is the tree_code for the right-hand side of the assignment.
-     * Op1, op2 and op3 are the operands.
-     *
-     * "%G <", gs
-     *
-     * *******************************************/
-    std::vector<tree_value_t> gbind_bind_vars;
-
-    std::vector<gimple_stmt_data> gbind_bind_body;
-
-    /**********************************************
-     * GIMPLE_CALL
-     *
-     * Build a GIMPLE_CALL statement to function FN.
-     * The argument FN must be either a FUNCTION_DECL or a gimple call address
-     * as determined by is_gimple_call_addr. NARGS are the number of arguments.
-     * The rest of the arguments follow the argument NARGS, and must be trees
-     * that are valid as rvalues in gimple (i.e., each operand is validated with
-     * is_gimple_operand).
-     *
-     *
-     *
-     * *******************************************/
     bool gcall_isinternal_only_function = false;
     std::string gcall_internal_function_name;
 
@@ -238,7 +421,7 @@ typedef struct _gimple_stmt_data
     tree_value_t gcall_lhs_arg;
 
     bool gcall_is_tm_clone = false;
-    std::vector<std::string> gcall_transaction_code_properties;
+    extract_vector<std::string> gcall_transaction_code_properties;
     bool gcall_is_marked_for_return_slot_optimization = false;
     bool gcall_is_marked_as_a_tail_call = false;
     bool gcall_is_marked_as_requiring_tail_call_optimization = false;
@@ -247,18 +430,23 @@ typedef struct _gimple_stmt_data
     tree_value_t gcall_static_chain_for_call_statement;
 
     tree_value_t gcall_fn;
-    std::vector<tree_value_t> gcall_args;
-
-    /**********************************************
-     * GIMPLE_COND
-     *
-     * A GIMPLE_COND statement compares LHS and RHS and if the condition in
-     * PRED_CODE is true, jump to the label in t_label, otherwise jump to the
-     * label in f_label. PRED_CODE are relational operator tree codes like
-     * EQ_EXPR, LT_EXPR, LE_EXPR, NE_EXPR, etc.
-     *
-     *
-     * *******************************************/
+    extract_vector<tree_value_t> gcall_args;
+} gimple_call_data_t;
+
+/**********************************************
+ * GIMPLE_COND
+ *
+ * A GIMPLE_COND statement compares LHS and RHS and if the condition in
+ * PRED_CODE is true, jump to the label in t_label, otherwise jump to the
+ * label in f_label. PRED_CODE are relational operator tree codes like
+ * EQ_EXPR, LT_EXPR, LE_EXPR, NE_EXPR, etc.
+ *
+ *
+ * *******************************************/
+typedef struct _gimple_cond_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_COND;
+
     bool gcond_has_true_goto_label = false;
     bool gcond_has_false_else_goto_label = false;
 
@@ -273,92 +461,141 @@ typedef struct _gimple_stmt_data
 
     int goto_true_edge = 0;
     int else_goto_false_edge = 0;
+} gimple_cond_data_t;
+
+/**********************************************
+ * GIMPLE_LABEL
+ *
+ * *******************************************/
+typedef struct _gimple_label_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_LABEL;
 
-    /**********************************************
-     * GIMPLE_LABEL
-     *
-     * *******************************************/
     tree_value_t glabel_label;
     bool glabel_is_non_local = false;
+} gimple_label_data_t;
+
+/**********************************************
+ * GIMPLE_GOTO
+ * GIMPLE_GOTO statement to label destination (DEST) of the unconditional
+ * jump G
+ *
+ * *******************************************/
+typedef struct _gimple_goto_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_GOTO;
 
-    /**********************************************
-     * GIMPLE_GOTO
-     * GIMPLE_GOTO statement to label destination (DEST) of the unconditional
-     * jump G
-     *
-     * *******************************************/
     tree_value_t ggoto_dest_goto_label;
+} gimple_goto_data_t;
 
-    /**********************************************
-     * GIMPLE_NOP
-     *
-     * *******************************************/
-    std::string gnop_nop_str;
+/**********************************************
+ * GIMPLE_RETURN
+ *
+ * *******************************************/
+typedef struct _gimple_return_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_RETURN;
 
-    /**********************************************
-     * GIMPLE_RETURN
-     *
-     * *******************************************/
     bool greturn_has_greturn_return_value = false;
     tree_value_t greturn_return_value;
+} gimple_return_data_t;
+
+/**********************************************
+ * GIMPLE_SWITCH
+ * INDEX is the index variable to switch on, and DEFAULT_LABEL represents
+ * the default label ARGS is a vector of CASE_LABEL_EXPR trees that contain
+ * the non-default case labels. Each label is a tree of code CASE_
+ * LABEL_EXPR.
+ *
+ * *******************************************/
+typedef struct _gimple_switch_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_SWITCH;
 
-    /**********************************************
-     * GIMPLE_SWITCH
-     * INDEX is the index variable to switch on, and DEFAULT_LABEL represents
-     * the default label ARGS is a vector of CASE_LABEL_EXPR trees that contain
-     * the non-default case labels. Each label is a tree of code CASE_
-     * LABEL_EXPR.
-     *
-     * *******************************************/
     tree_value_t gswitch_switch_index;
-    std::vector<tree_value_t> gswitch_switch_case_labels;
-    std::vector<tree_value_t> gswitch_switch_labels;
-
-    /**********************************************
-     * GIMPLE_TRY
-     * KIND is the enumeration value GIMPLE_TRY_CATCH if this statement denotes
-     * a try/catch construct or GIMPLE_ TRY_FINALLY if this statement denotes a
-     * try/finally construct. EVAL is a sequence with the expression to
-     * evaluate. CLEANUP is a sequence of statements to run at clean-up time.
-     *
-     * *******************************************/
+    extract_vector<tree_value_t> gswitch_switch_case_labels;
+    extract_vector<tree_value_t> gswitch_switch_labels;
+} gimple_switch_data_t;
+
+/**********************************************
+ * GIMPLE_TRY
+ * KIND is the enumeration value GIMPLE_TRY_CATCH if this statement denotes
+ * a try/catch construct or GIMPLE_ TRY_FINALLY if this statement denotes a
+ * try/finally construct. EVAL is a sequence with the expression to
+ * evaluate. CLEANUP is a sequence of statements to run at clean-up time.
+ *
+ * *******************************************/
+typedef struct _gimple_try_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_TRY;
+
     std::string gtry_try_type_kind = "UNKNOWN_GIMPLE_TRY";
 
     bool gtry_has_try_cleanup = false;
 
-    std::vector<gimple_stmt_data> gtry_try_cleanup;
-    std::vector<gimple_stmt_data> gtry_try_eval;
+    extract_vector<gimple_stmt_data> gtry_try_cleanup;
+    extract_vector<gimple_stmt_data> gtry_try_eval;
+} gimple_try_data_t;
+
+/**********************************************
+ * GIMPLE_PHI
+ *
+ * *******************************************/
+typedef struct _gimple_phi_data : gimple_stmt_payload
+{
+    static const enum gimple_code code = GIMPLE_PHI;
 
-    /**********************************************
-     * GIMPLE_PHI
-     *
-     * *******************************************/
     tree_value_t gphi_lhs;
 
-    std::vector<tree_value_t> gphi_phi_args;
-    std::vector<int> gphi_phi_args_basicblock_src_index;
-    std::vector<std::string> gphi_phi_args_locations;
-
-} gimple_stmt_data;
+    extract_vector<tree_value_t> gphi_phi_args;
+    extract_vector<int> gphi_phi_args_basicblock_src_index;
+    extract_vector<std::string> gphi_phi_args_locations;
+} gimple_phi_data_t;
 
 std::vector<int> getRangeVector(int start, int end);
 std::vector<std::string> readFileToVector(const std::string& filename);
 
-void write_function_to_file(std::string filename, std::string function_name, std::string function_extract_dump);
-
-gimple_stmt_data gimple_tuple_to_stmt_data(gimple *g, int bb_index, std::vector<int> &bb_edges);
+std::string get_stage_dir(std::string stage);
+std::string get_output_dir_path(std::string filename, std::string stage_dir);
+std::string get_function_output_name(function *fun, const function_data_t &fn_data);
+std::string get_function_output_path(std::string filename, std::string function_name, std::string stage_dir);
+void write_function_to_file(std::string filename, std::string function_name, std::string stage_dir, std::string function_extract_dump);
+std::string get_lto_unit_name();
+std::string get_unit_filename();
+std::string get_unit_hash();
+std::string get_unit_output_path();
+std::string get_unit_pack_path();
+std::string get_unit_type_table_name();
+std::string get_unit_shard_path();
+void open_unit_data_pack();
+void write_function_to_pack(std::string function_name, std::string function_extract_dump);
+void write_unit_type_table();
+void collect_unit_symbol_table();
+void write_unit_symbol_table();
+void collect_unit_call_graph();
+void write_unit_call_graph();
+void write_unit_stats();
+std::string get_unit_manifest_path();
+uint64_t get_function_fingerprint(function *fun, const function_data_t &fn_data);
+uint64_t get_output_fingerprint(const std::string &dump);
+void get_cfg_info(function *fun, cfg_info_t &cfg_info);
+
+gimple_stmt_data gimple_tuple_to_stmt_data(gimple *g, int bb_index, extract_vector<int> &bb_edges);
 const std::string bool_cast(const bool b);
 void gimple_tuple_args(gimple *g, gimple_stmt_data &stmt_data);
-void get_tree_data_values(tree node, std::vector<data_value_t> &dvalues);
-void append_simple_value(std::vector<data_value_t> &dvalues, data_value_t &dvalue, std::string value);
-void append_complex_value(std::vector<data_value_t> &dvalues, data_value_t &dvalue, std::vector<data_value_t> &complex_dvalues);
+void get_tree_data_values(tree node, extract_vector<data_value_t> &dvalues);
+void clear_tree_data_values_cache();
+void take_tree_data_values_cache(tree_values_cache_t &cache);
+void append_simple_value(extract_vector<data_value_t> &dvalues, data_value_t &dvalue, std::string value);
+void append_token_value(extract_vector<data_value_t> &dvalues, data_value_t &dvalue, enum data_token token, const char *value);
+void append_complex_value(extract_vector<data_value_t> &dvalues, data_value_t &dvalue, extract_vector<data_value_t> &complex_dvalues);
 void get_basic_tree_node_info(tree tree_node, data_value_t &dvalue);
-void ppp_tree_identifier(std::vector<data_value_t> &dvalues, data_value_t &dvalue, tree id);
+void ppp_tree_identifier(extract_vector<data_value_t> &dvalues, data_value_t &dvalue, tree id);
 void get_gimple_mem_ops (const gimple *gs, gimple_stmt_data &stmt_data);
 void gimple_tuple_arg_values(gimple *g, gimple_stmt_data &stmt_data);
-void print_declaration(tree t, std::vector<data_value_t> &dvalues, data_value_t &dvalue);
+void print_declaration(tree t, extract_vector<data_value_t> &dvalues, data_value_t &dvalue);
 
-gimple_phi_t dump_gimple_phi(const gphi *phi, basicblock_t &bb_data);
+gimple_phi_t dump_gimple_phi(const gphi *phi);
 void dump_phi_nodes(basic_block bb, basicblock_t &bb_data);
 
 void dump_gimple_asm(const gasm *gs, gimple_stmt_data &stmt_data);
@@ -376,41 +613,41 @@ void dump_gimple_phi(const gphi *phi, gimple_stmt_data &stmt_data);
 
 #define ppp_string(dvalues, dvalue, str) 	    append_simple_value(dvalues, dvalue, str);
 #define ppp_decimal_int(dvalues, dvalue, val) append_simple_value(dvalues, dvalue, std::to_string(val));
-#define ppp_space(dvalues, dvalue)            append_simple_value(dvalues, dvalue, " ");
-#define ppp_left_paren(dvalues, dvalue)       append_simple_value(dvalues, dvalue, "(");
-#define ppp_right_paren(dvalues, dvalue)      append_simple_value(dvalues, dvalue, ")");
-#define ppp_left_bracket(dvalues, dvalue)     append_simple_value(dvalues, dvalue, "[");
-#define ppp_right_bracket(dvalues, dvalue)    append_simple_value(dvalues, dvalue, "]");
-#define ppp_left_brace(dvalues, dvalue)       append_simple_value(dvalues, dvalue, "{");
-#define ppp_right_brace(dvalues, dvalue)      append_simple_value(dvalues, dvalue, "}");
-#define ppp_semicolon(dvalues, dvalue)        append_simple_value(dvalues, dvalue, ";");
-#define ppp_comma(dvalues, dvalue)            append_simple_value(dvalues, dvalue, ",");
-#define ppp_dot(dvalues, dvalue)              append_simple_value(dvalues, dvalue, ".");
-#define ppp_colon(dvalues, dvalue)            append_simple_value(dvalues, dvalue, ":");
-#define ppp_colon_colon(dvalues, dvalue)      append_simple_value(dvalues, dvalue, "::");
-#define ppp_arrow(dvalues, dvalue)            append_simple_value(dvalues, dvalue, "->");
-#define ppp_equal(dvalues, dvalue)            append_simple_value(dvalues, dvalue, "=");
-#define ppp_question(dvalues, dvalue)         append_simple_value(dvalues, dvalue, "?");
-#define ppp_bar(dvalues, dvalue)              append_simple_value(dvalues, dvalue, "|");
-#define ppp_bar_bar(dvalues, dvalue)          append_simple_value(dvalues, dvalue, "||");
-#define ppp_carret(dvalues, dvalue)           append_simple_value(dvalues, dvalue, "^");
-#define ppp_ampersand(dvalues, dvalue)        append_simple_value(dvalues, dvalue, "&");
-#define ppp_ampersand_ampersand(dvalues, dvalue) append_simple_value(dvalues, dvalue, "&&");
-#define ppp_less(dvalues, dvalue)             append_simple_value(dvalues, dvalue, "<");
-#define ppp_less_equal(dvalues, dvalue)       append_simple_value(dvalues, dvalue, "<=");
-#define ppp_greater(dvalues, dvalue)          append_simple_value(dvalues, dvalue, ">");
-#define ppp_greater_equal(dvalues, dvalue)    append_simple_value(dvalues, dvalue, ">=");
-#define ppp_plus(dvalues, dvalue)             append_simple_value(dvalues, dvalue, "+");
-#define ppp_minus(dvalues, dvalue)            append_simple_value(dvalues, dvalue, "-");
-#define ppp_star(dvalues, dvalue)             append_simple_value(dvalues, dvalue, "*");
-#define ppp_slash(dvalues, dvalue)            append_simple_value(dvalues, dvalue, "/");
-#define ppp_modulo(dvalues, dvalue)           append_simple_value(dvalues, dvalue, "%");
-#define ppp_exclamation(dvalues, dvalue)      append_simple_value(dvalues, dvalue, "!");
-#define ppp_complement(dvalues, dvalue)       append_simple_value(dvalues, dvalue, "~");
-#define ppp_quote(dvalues, dvalue)            append_simple_value(dvalues, dvalue, "\'");
-#define ppp_backquote(dvalues, dvalue)        append_simple_value(dvalues, dvalue, "`");
-#define ppp_doublequote(dvalues, dvalue)      append_simple_value(dvalues, dvalue, "\"");
-#define ppp_underscore(dvalues, dvalue)       append_simple_value(dvalues, dvalue, "_");
+#define ppp_space(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_SPACE, " ");
+#define ppp_left_paren(dvalues, dvalue)       append_token_value(dvalues, dvalue, DATA_TOKEN_LEFT_PAREN, "(");
+#define ppp_right_paren(dvalues, dvalue)      append_token_value(dvalues, dvalue, DATA_TOKEN_RIGHT_PAREN, ")");
+#define ppp_left_bracket(dvalues, dvalue)     append_token_value(dvalues, dvalue, DATA_TOKEN_LEFT_BRACKET, "[");
+#define ppp_right_bracket(dvalues, dvalue)    append_token_value(dvalues, dvalue, DATA_TOKEN_RIGHT_BRACKET, "]");
+#define ppp_left_brace(dvalues, dvalue)       append_token_value(dvalues, dvalue, DATA_TOKEN_LEFT_BRACE, "{");
+#define ppp_right_brace(dvalues, dvalue)      append_token_value(dvalues, dvalue, DATA_TOKEN_RIGHT_BRACE, "}");
+#define ppp_semicolon(dvalues, dvalue)        append_token_value(dvalues, dvalue, DATA_TOKEN_SEMICOLON, ";");
+#define ppp_comma(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_COMMA, ",");
+#define ppp_dot(dvalues, dvalue)              append_token_value(dvalues, dvalue, DATA_TOKEN_DOT, ".");
+#define ppp_colon(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_COLON, ":");
+#define ppp_colon_colon(dvalues, dvalue)      append_token_value(dvalues, dvalue, DATA_TOKEN_COLON_COLON, "::");
+#define ppp_arrow(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_ARROW, "->");
+#define ppp_equal(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_EQUAL, "=");
+#define ppp_question(dvalues, dvalue)         append_token_value(dvalues, dvalue, DATA_TOKEN_QUESTION, "?");
+#define ppp_bar(dvalues, dvalue)              append_token_value(dvalues, dvalue, DATA_TOKEN_BAR, "|");
+#define ppp_bar_bar(dvalues, dvalue)          append_token_value(dvalues, dvalue, DATA_TOKEN_BAR_BAR, "||");
+#define ppp_carret(dvalues, dvalue)           append_token_value(dvalues, dvalue, DATA_TOKEN_CARRET, "^");
+#define ppp_ampersand(dvalues, dvalue)        append_token_value(dvalues, dvalue, DATA_TOKEN_AMPERSAND, "&");
+#define ppp_ampersand_ampersand(dvalues, dvalue) append_token_value(dvalues, dvalue, DATA_TOKEN_AMPERSAND_AMPERSAND, "&&");
+#define ppp_less(dvalues, dvalue)             append_token_value(dvalues, dvalue, DATA_TOKEN_LESS, "<");
+#define ppp_less_equal(dvalues, dvalue)       append_token_value(dvalues, dvalue, DATA_TOKEN_LESS_EQUAL, "<=");
+#define ppp_greater(dvalues, dvalue)          append_token_value(dvalues, dvalue, DATA_TOKEN_GREATER, ">");
+#define ppp_greater_equal(dvalues, dvalue)    append_token_value(dvalues, dvalue, DATA_TOKEN_GREATER_EQUAL, ">=");
+#define ppp_plus(dvalues, dvalue)             append_token_value(dvalues, dvalue, DATA_TOKEN_PLUS, "+");
+#define ppp_minus(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_MINUS, "-");
+#define ppp_star(dvalues, dvalue)             append_token_value(dvalues, dvalue, DATA_TOKEN_STAR, "*");
+#define ppp_slash(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_SLASH, "/");
+#define ppp_modulo(dvalues, dvalue)           append_token_value(dvalues, dvalue, DATA_TOKEN_MODULO, "%");
+#define ppp_exclamation(dvalues, dvalue)      append_token_value(dvalues, dvalue, DATA_TOKEN_EXCLAMATION, "!");
+#define ppp_complement(dvalues, dvalue)       append_token_value(dvalues, dvalue, DATA_TOKEN_COMPLEMENT, "~");
+#define ppp_quote(dvalues, dvalue)            append_token_value(dvalues, dvalue, DATA_TOKEN_QUOTE, "\'");
+#define ppp_backquote(dvalues, dvalue)        append_token_value(dvalues, dvalue, DATA_TOKEN_BACKQUOTE, "`");
+#define ppp_doublequote(dvalues, dvalue)      append_token_value(dvalues, dvalue, DATA_TOKEN_DOUBLEQUOTE, "\"");
+#define ppp_underscore(dvalues, dvalue)       append_token_value(dvalues, dvalue, DATA_TOKEN_UNDERSCORE, "_");
 
 
 #define DECL_IS_UNDECLARED_BUILTIN(DECL) \
@@ -0,0 +1,130 @@
+#include "output_dirs.h"
+#include <cerrno>
+#include <mutex>
+#include <unordered_set>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <direct.h>
+#endif
+
+static std::mutex output_dirs_mutex;
+
+// directories known to exist, without trailing separators
+static std::unordered_set<std::string> created_dirs;
+
+static std::string output_root;
+static int output_root_fd = -1;
+// the root is created and opened by the first write below it
+static bool output_root_opened = false;
+
+static std::string
+strip_trailing_slashes (const std::string &path)
+{
+    size_t end = path.find_last_not_of ('/');
+    if (end == std::string::npos)
+        return path.empty () ? path : "/";
+    return path.substr (0, end + 1);
+}
+
+/* Create the single directory PATH, whose parent exists.  */
+static bool
+make_directory (const std::string &path)
+{
+#ifdef _WIN32
+    return _mkdir (path.c_str ()) == 0 || errno == EEXIST;
+#else
+    int result;
+    if (output_root_fd >= 0 && path.size () > output_root.size ()
+        && path.compare (0, output_root.size (), output_root) == 0
+        && path[output_root.size ()] == '/')
+        result = mkdirat (output_root_fd,
+                          path.c_str () + output_root.size () + 1, 0755);
+    else
+        result = mkdir (path.c_str (), 0755);
+
+    // EEXIST is also returned for a file in the way, which the caller finds
+    // out when opening its output
+    return result == 0 || errno == EEXIST;
+#endif
+}
+
+static bool
+create_directories_locked (const std::string &path)
+{
+    if (path.empty () || created_dirs.count (path))
+        return true;
+
+    // create the parents first, most of them are already known
+    size_t pos = path.find_last_of ('/');
+    if (pos != std::string::npos && pos > 0)
+        {
+            if (!create_directories_locked (path.substr (0, pos)))
+                return false;
+        }
+
+    if (!make_directory (path))
+        return false;
+
+    created_dirs.insert (path);
+    return true;
+}
+
+/* Create and open the output root, once.  */
+static void
+open_output_root_locked ()
+{
+    output_root_opened = true;
+    if (!create_directories_locked (output_root))
+        return;
+
+#ifndef _WIN32
+    output_root_fd = open (output_root.c_str (), O_RDONLY | O_DIRECTORY);
+#endif
+}
+
+void
+open_output_dirs (const std::string &output_path)
+{
+    std::lock_guard<std::mutex> lock (output_dirs_mutex);
+
+#ifndef _WIN32
+    if (output_root_fd >= 0)
+        close (output_root_fd);
+#endif
+    output_root_fd = -1;
+    output_root_opened = false;
+    output_root = strip_trailing_slashes (output_path);
+}
+
+void
+close_output_dirs ()
+{
+    std::lock_guard<std::mutex> lock (output_dirs_mutex);
+
+#ifndef _WIN32
+    if (output_root_fd >= 0)
+        close (output_root_fd);
+#endif
+    output_root_fd = -1;
+    output_root_opened = false;
+    created_dirs.clear ();
+}
+
+bool
+create_output_directories (const std::string &path)
+{
+    std::lock_guard<std::mutex> lock (output_dirs_mutex);
+    std::string dir_path = strip_trailing_slashes (path);
+
+    if (!output_root_opened && !output_root.empty ()
+        && dir_path.compare (0, output_root.size (), output_root) == 0
+        && (dir_path.size () == output_root.size ()
+            || dir_path[output_root.size ()] == '/'))
+        open_output_root_locked ();
+
+    return create_directories_locked (dir_path);
+}
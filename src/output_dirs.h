@@ -0,0 +1,26 @@
+#ifndef H_OUTPUT_DIRS_
+#define H_OUTPUT_DIRS_
+
+#include <string>
+
+/*
+ * Output directory creation.
+ *
+ * Directories created (or found to exist) are remembered for the lifetime
+ * of the compiler, so every directory is touched once per compile instead
+ * of once per function and path component. Directories below the output
+ * path are created with mkdirat relative to a descriptor opened on it, so
+ * the output path itself is not looked up again.
+ */
+
+/* Use OUTPUT_PATH as the output root. Nothing is created until the first
+   create_output_directories () below it, which creates and opens the root
+   (directories are created from absolute paths when it cannot be opened),
+   so a compile that writes nothing leaves no directory behind.  */
+void open_output_dirs (const std::string &output_path);
+void close_output_dirs ();
+
+/* Create PATH and its missing parents. Thread safe.  */
+bool create_output_directories (const std::string &path);
+
+#endif
@@ -0,0 +1,329 @@
+#include "output_file.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+enum output_fsync config_fsync = OUTPUT_FSYNC_NONE;
+
+static std::atomic<unsigned> temp_output_count (0);
+
+// complete temporary files and their final paths, renamed by
+// sync_output_files () with OUTPUT_FSYNC_UNIT
+static std::mutex pending_mutex;
+static std::vector<std::pair<std::string, std::string> > pending_files;
+
+static std::string
+system_error (const std::string &what, const std::string &path)
+{
+    return what + " " + path + ": " + strerror (errno);
+}
+
+static std::string
+parent_directory (const std::string &path)
+{
+    size_t pos = path.find_last_of ('/');
+    if (pos == std::string::npos)
+        return ".";
+    return pos == 0 ? "/" : path.substr (0, pos);
+}
+
+static bool
+sync_path (const std::string &path, int flags, std::string &error)
+{
+    int fd = open (path.c_str (), flags | O_CLOEXEC);
+    if (fd < 0)
+        {
+            error = system_error ("error opening", path);
+            return false;
+        }
+
+    bool ok = fsync (fd) == 0;
+    if (!ok)
+        error = system_error ("error syncing", path);
+
+    close (fd);
+    return ok;
+}
+
+std::string
+get_temp_output_path (const std::string &path)
+{
+    return path + ".tmp." + std::to_string (getpid ()) + "."
+           + std::to_string (temp_output_count++);
+}
+
+static bool
+rename_temp_file (const std::string &temp_path, const std::string &path,
+                  std::string &error)
+{
+    if (rename (temp_path.c_str (), path.c_str ()) != 0)
+        {
+            error = system_error ("error renaming", temp_path);
+            unlink (temp_path.c_str ());
+            return false;
+        }
+
+    return true;
+}
+
+/* Rename the complete (and, with OUTPUT_FSYNC_FILE, synced) TEMP_PATH, or
+   with OUTPUT_FSYNC_UNIT leave that to sync_output_files () so the data is
+   on disk before the final path refers to it.  */
+static bool
+rename_output_file (const std::string &temp_path, const std::string &path,
+                    std::string &error)
+{
+    if (config_fsync == OUTPUT_FSYNC_UNIT)
+        {
+            std::lock_guard<std::mutex> lock (pending_mutex);
+            pending_files.emplace_back (temp_path, path);
+            return true;
+        }
+
+    if (!rename_temp_file (temp_path, path, error))
+        return false;
+
+    // the rename itself is only durable once the directory is synced
+    if (config_fsync == OUTPUT_FSYNC_FILE)
+        return sync_path (parent_directory (path), O_RDONLY | O_DIRECTORY,
+                          error);
+
+    return true;
+}
+
+bool
+commit_output_file (const std::string &temp_path, const std::string &path,
+                    std::string &error)
+{
+    if (config_fsync == OUTPUT_FSYNC_FILE
+        && !sync_path (temp_path, O_RDONLY, error))
+        {
+            unlink (temp_path.c_str ());
+            return false;
+        }
+
+    return rename_output_file (temp_path, path, error);
+}
+
+/* Create TEMP_PATH with DATA, removed again on failure.  */
+static bool
+write_temp_file (const std::string &temp_path, const std::string &data,
+                 std::string &error)
+{
+    int fd = open (temp_path.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                   0644);
+    if (fd < 0)
+        {
+            error = system_error ("error creating", temp_path);
+            return false;
+        }
+
+    const char *buffer = data.data ();
+    size_t remaining = data.size ();
+    while (remaining > 0)
+        {
+            ssize_t written = write (fd, buffer, remaining);
+            if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+
+                    error = system_error ("error writing", temp_path);
+                    close (fd);
+                    unlink (temp_path.c_str ());
+                    return false;
+                }
+
+            buffer += written;
+            remaining -= written;
+        }
+
+    if (config_fsync == OUTPUT_FSYNC_FILE && fsync (fd) != 0)
+        {
+            error = system_error ("error syncing", temp_path);
+            close (fd);
+            unlink (temp_path.c_str ());
+            return false;
+        }
+
+    // close reports delayed write errors, e.g. on NFS
+    if (close (fd) != 0)
+        {
+            error = system_error ("error closing", temp_path);
+            unlink (temp_path.c_str ());
+            return false;
+        }
+
+    return true;
+}
+
+bool
+write_output_file (const std::string &path, const std::string &data,
+                   std::string &error)
+{
+    std::string temp_path = get_temp_output_path (path);
+    if (!write_temp_file (temp_path, data, error))
+        return false;
+
+    return rename_output_file (temp_path, path, error);
+}
+
+static std::string
+get_claim_path (const std::string &path)
+{
+    return path + ".claim";
+}
+
+/* Read the owner, key and pid recorded by claim_output_file (), false with
+   errno set when CLAIM_PATH cannot be read.  */
+static bool
+read_claim (const std::string &claim_path, std::string &owner,
+            std::string &key, long &pid)
+{
+    std::ifstream file (claim_path);
+    if (!file.is_open ())
+        return false;
+
+    std::string pid_line;
+    if (!std::getline (file, owner) || !std::getline (file, key)
+        || !std::getline (file, pid_line))
+        {
+            // a claim is renamed into place complete, so this is corrupt
+            owner.clear ();
+            key.clear ();
+        }
+
+    pid = strtol (pid_line.c_str (), nullptr, 10);
+    return true;
+}
+
+static bool
+is_process_running (long pid)
+{
+    if (pid <= 0)
+        return false;
+
+    return kill (pid, 0) == 0 || errno == EPERM;
+}
+
+enum output_claim
+claim_output_file (const std::string &path, const std::string &owner,
+                   const std::string &key, std::string &error)
+{
+    std::string claim_path = get_claim_path (path);
+    std::string temp_path = get_temp_output_path (claim_path);
+    std::string claim
+        = owner + "\n" + key + "\n" + std::to_string (getpid ()) + "\n";
+
+    if (!write_temp_file (temp_path, claim, error))
+        return OUTPUT_CLAIM_ERROR;
+
+    // a claim released or taken over meanwhile is looked at again
+    for (int attempt = 0; attempt < 3; attempt++)
+        {
+            // unlike rename, link never replaces an existing claim
+            if (link (temp_path.c_str (), claim_path.c_str ()) == 0)
+                {
+                    unlink (temp_path.c_str ());
+                    return OUTPUT_CLAIM_TAKEN;
+                }
+
+            if (errno != EEXIST)
+                {
+                    error = system_error ("error claiming", claim_path);
+                    unlink (temp_path.c_str ());
+                    return OUTPUT_CLAIM_ERROR;
+                }
+
+            std::string claim_owner, claim_key;
+            long claim_pid;
+            if (!read_claim (claim_path, claim_owner, claim_key, claim_pid))
+                {
+                    if (errno == ENOENT)
+                        continue;
+
+                    error = system_error ("error reading", claim_path);
+                    unlink (temp_path.c_str ());
+                    return OUTPUT_CLAIM_ERROR;
+                }
+
+            bool is_stale
+                = claim_owner == owner || claim_key != key
+                  || (access (path.c_str (), F_OK) != 0
+                      && !is_process_running (claim_pid));
+            if (!is_stale)
+                {
+                    unlink (temp_path.c_str ());
+                    return OUTPUT_CLAIM_HELD;
+                }
+
+            if (rename (temp_path.c_str (), claim_path.c_str ()) != 0)
+                {
+                    error = system_error ("error claiming", claim_path);
+                    unlink (temp_path.c_str ());
+                    return OUTPUT_CLAIM_ERROR;
+                }
+
+            return OUTPUT_CLAIM_TAKEN;
+        }
+
+    error = "error claiming " + claim_path + ": claim keeps changing";
+    unlink (temp_path.c_str ());
+    return OUTPUT_CLAIM_ERROR;
+}
+
+void
+release_output_claim (const std::string &path)
+{
+    unlink (get_claim_path (path).c_str ());
+}
+
+bool
+sync_output_files (std::string &error)
+{
+    std::vector<std::pair<std::string, std::string> > files;
+    {
+        std::lock_guard<std::mutex> lock (pending_mutex);
+        files.swap (pending_files);
+    }
+
+    bool ok = true;
+    std::set<std::string> directories;
+    for (auto &file : files)
+        {
+            // a file that cannot be synced keeps the previous version
+            if (!sync_path (file.first, O_RDONLY, error))
+                {
+                    unlink (file.first.c_str ());
+                    ok = false;
+                    continue;
+                }
+
+            if (!rename_temp_file (file.first, file.second, error))
+                {
+                    ok = false;
+                    continue;
+                }
+
+            directories.insert (parent_directory (file.second));
+        }
+
+    for (auto &path : directories)
+        {
+            if (!sync_path (path, O_RDONLY | O_DIRECTORY, error))
+                ok = false;
+        }
+
+    return ok;
+}
@@ -0,0 +1,72 @@
+#ifndef H_OUTPUT_FILE_
+#define H_OUTPUT_FILE_
+
+#include <string>
+
+/*
+ * Crash-safe output files.
+ *
+ * Every output is written to a temporary file next to it
+ * (`<path>.tmp.<pid>.<n>`) and renamed over the final path once complete,
+ * so readers only ever see a previous or a complete version. A process
+ * killed mid-write leaves the temporary file behind and the final path
+ * untouched.
+ *
+ * config_fsync decides when the data reaches the disk:
+ *
+ *   OUTPUT_FSYNC_NONE  never, the kernel writes it back on its own
+ *   OUTPUT_FSYNC_UNIT  once per translation unit, see sync_output_files ();
+ *                      outputs keep their temporary path until then
+ *   OUTPUT_FSYNC_FILE  every file and its directory, before returning
+ */
+
+enum output_fsync
+{
+    OUTPUT_FSYNC_NONE,
+    OUTPUT_FSYNC_UNIT,
+    OUTPUT_FSYNC_FILE
+};
+
+extern enum output_fsync config_fsync;
+
+/* Unique temporary path for an output that will be renamed to PATH.  */
+std::string get_temp_output_path (const std::string &path);
+
+/* Apply config_fsync to the complete file TEMP_PATH and rename it to PATH.
+   TEMP_PATH is removed on failure.  */
+bool commit_output_file (const std::string &temp_path, const std::string &path,
+                         std::string &error);
+
+/* Write DATA to PATH through a temporary file.  */
+bool write_output_file (const std::string &path, const std::string &data,
+                        std::string &error);
+
+enum output_claim
+{
+    // this compilation writes the output
+    OUTPUT_CLAIM_TAKEN,
+    // another compilation wrote it, or is still writing it
+    OUTPUT_CLAIM_HELD,
+    OUTPUT_CLAIM_ERROR
+};
+
+/* Claim the output PATH for OWNER through `<PATH>.claim`, which records
+   OWNER, KEY and the pid of this process.  The claim is created atomically
+   when there is none.  An existing one is taken over when it has the same
+   OWNER (that compilation runs again) or another KEY (the output changed),
+   or when PATH does not exist and the process that claimed it is gone (it
+   failed before writing PATH).  Otherwise it is held.  */
+enum output_claim claim_output_file (const std::string &path,
+                                     const std::string &owner,
+                                     const std::string &key,
+                                     std::string &error);
+
+/* Drop the claim on PATH taken by claim_output_file (), when PATH could
+   not be written.  */
+void release_output_claim (const std::string &path);
+
+/* With OUTPUT_FSYNC_UNIT, flush every file committed since the last call
+   and rename it to its final path, then flush their directories.  */
+bool sync_output_files (std::string &error);
+
+#endif
@@ -0,0 +1,150 @@
+#include "source_cache.h"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// source files keyed by canonical path, released at the end of the unit
+static std::map<std::string, std::unique_ptr<source_file_t> > source_cache;
+
+static bool
+map_source_file (source_file_t &source_file)
+{
+#ifdef _WIN32
+    return false;
+#else
+    int fd = open (source_file.path.c_str (), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat (fd, &info) != 0 || !S_ISREG (info.st_mode))
+        {
+            close (fd);
+            return false;
+        }
+
+    // mmap refuses empty mappings, an empty file simply has no lines
+    if (info.st_size == 0)
+        {
+            close (fd);
+            return true;
+        }
+
+    void *addr = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+
+    if (addr == MAP_FAILED)
+        return false;
+
+    source_file.data = static_cast<const char *> (addr);
+    source_file.size = info.st_size;
+    source_file.is_mapped = true;
+    return true;
+#endif
+}
+
+static bool
+read_source_file (source_file_t &source_file)
+{
+    std::ifstream file (source_file.path, std::ios::in | std::ios::binary);
+
+    if (!file.is_open ())
+        return false;
+
+    std::stringstream ss;
+    ss << file.rdbuf ();
+    source_file.contents = ss.str ();
+    source_file.data = source_file.contents.data ();
+    source_file.size = source_file.contents.size ();
+    return true;
+}
+
+static void
+index_source_lines (source_file_t &source_file)
+{
+    // same line splitting as std::getline: a trailing newline does not
+    // start an extra empty line
+    size_t line_start = 0;
+    for (size_t i = 0; i < source_file.size; ++i)
+        {
+            if (source_file.data[i] == '\n')
+                {
+                    source_file.line_offsets.push_back (line_start);
+                    line_start = i + 1;
+                }
+        }
+
+    if (line_start < source_file.size)
+        source_file.line_offsets.push_back (line_start);
+}
+
+const source_file_t *
+get_source_file (const std::string &filename)
+{
+    auto it = source_cache.find (filename);
+    if (it != source_cache.end ())
+        return it->second.get ();
+
+    std::unique_ptr<source_file_t> source_file (new source_file_t);
+    source_file->path = filename;
+
+    if (!map_source_file (*source_file) && !read_source_file (*source_file))
+        {
+            std::cerr << "Error: Unable to open file " << filename << std::endl;
+        }
+
+    index_source_lines (*source_file);
+
+    const source_file_t *result = source_file.get ();
+    source_cache[filename] = std::move (source_file);
+    return result;
+}
+
+int
+get_source_line_count (const source_file_t *source_file)
+{
+    return source_file->line_offsets.size ();
+}
+
+std::string
+get_source_line (const source_file_t *source_file, int lineno)
+{
+    int real_lineno = lineno - 1;
+    if (real_lineno < 0 || real_lineno >= get_source_line_count (source_file))
+        return std::string ("");
+
+    size_t start = source_file->line_offsets[real_lineno];
+    size_t end = source_file->size;
+
+    if (real_lineno + 1 < get_source_line_count (source_file))
+        end = source_file->line_offsets[real_lineno + 1] - 1;
+    else if (end > start && source_file->data[end - 1] == '\n')
+        end--;
+
+    return std::string (source_file->data + start, end - start);
+}
+
+void
+clear_source_cache ()
+{
+#ifndef _WIN32
+    for (auto &entry : source_cache)
+        {
+            source_file_t &source_file = *entry.second;
+            if (source_file.is_mapped)
+                munmap (const_cast<char *> (source_file.data),
+                        source_file.size);
+        }
+#endif
+    source_cache.clear ();
+}
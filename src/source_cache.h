@@ -0,0 +1,32 @@
+#ifndef H_SOURCE_CACHE_
+#define H_SOURCE_CACHE_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+ * A source file loaded once per translation unit.
+ *
+ * The file is memory-mapped when possible (falling back to reading it into
+ * `contents`), and `line_offsets` holds the byte offset at which every line
+ * starts, so fetching a line is a slice of `data`.
+ */
+typedef struct _source_file
+{
+    std::string path;
+
+    const char *data = nullptr;
+    size_t size = 0;
+    bool is_mapped = false;
+    std::string contents;
+
+    std::vector<size_t> line_offsets;
+} source_file_t;
+
+const source_file_t *get_source_file (const std::string &filename);
+int get_source_line_count (const source_file_t *source_file);
+std::string get_source_line (const source_file_t *source_file, int lineno);
+void clear_source_cache ();
+
+#endif
@@ -0,0 +1,84 @@
+#include "source_paths.h"
+#include <climits>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+// sorted by decreasing length, so the first match is the longest
+static std::vector<source_root_t> source_roots;
+
+static std::mutex canonical_paths_mutex;
+// empty when the name could not be resolved
+static std::unordered_map<std::string, std::string> canonical_paths;
+
+static bool
+resolve_path (const std::string &filename, std::string &path)
+{
+    char full_path[PATH_MAX];
+    if (realpath (filename.c_str (), full_path) == nullptr)
+        return false;
+
+    path = full_path;
+    return true;
+}
+
+static bool
+is_path_prefix (const std::string &prefix, const std::string &path)
+{
+    if (path.compare (0, prefix.size (), prefix) != 0)
+        return false;
+
+    return path.size () == prefix.size () || prefix.back () == '/'
+           || path[prefix.size ()] == '/';
+}
+
+bool
+add_source_root (const std::string &path, const std::string &output_subdir)
+{
+    source_root_t root;
+    if (!resolve_path (path, root.path))
+        return false;
+    root.output_subdir = output_subdir;
+
+    auto it = source_roots.begin ();
+    while (it != source_roots.end () && it->path.size () >= root.path.size ())
+        ++it;
+    source_roots.insert (it, root);
+
+    return true;
+}
+
+const std::vector<source_root_t> &
+get_source_roots ()
+{
+    return source_roots;
+}
+
+const source_root_t *
+find_source_root (const std::string &filename)
+{
+    for (auto &root : source_roots)
+        {
+            if (is_path_prefix (root.path, filename))
+                return &root;
+        }
+
+    return nullptr;
+}
+
+bool
+get_canonical_path (const std::string &filename, std::string &path)
+{
+    std::lock_guard<std::mutex> lock (canonical_paths_mutex);
+
+    auto it = canonical_paths.find (filename);
+    if (it == canonical_paths.end ())
+        {
+            std::string resolved;
+            resolve_path (filename, resolved);
+            it = canonical_paths.emplace (filename, resolved).first;
+        }
+
+    path = it->second;
+    return !path.empty ();
+}
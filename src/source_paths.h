@@ -0,0 +1,36 @@
+#ifndef H_SOURCE_PATHS_
+#define H_SOURCE_PATHS_
+
+#include <string>
+#include <vector>
+
+/*
+ * Source roots and canonical source paths.
+ *
+ * Only functions defined under one of the source roots are extracted. Each
+ * root may map to its own subdirectory of the output path; a file belongs
+ * to the longest root that is a prefix of its canonical path, on a path
+ * component boundary.
+ *
+ * The file names GCC reports are canonicalized with realpath once per
+ * distinct name and cached for the lifetime of the compiler.
+ */
+
+typedef struct _source_root
+{
+    std::string path;
+    std::string output_subdir;
+} source_root_t;
+
+/* PATH is canonicalized, false when it does not exist.  */
+bool add_source_root (const std::string &path,
+                      const std::string &output_subdir);
+const std::vector<source_root_t> &get_source_roots ();
+
+/* Longest root containing the canonical path FILENAME, or null.  */
+const source_root_t *find_source_root (const std::string &filename);
+
+/* Canonical form of FILENAME, false when it cannot be resolved.  */
+bool get_canonical_path (const std::string &filename, std::string &path);
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * exit () while the writer pool is running (GCC's fatal_error path) must
+ * not reach std::terminate through a joinable worker thread.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "async_writer.h"
+
+
+class counting_job : public async_job
+{
+  public:
+    void run () override {}
+    void commit () override { committed++; }
+
+    static int committed;
+};
+
+int counting_job::committed = 0;
+
+static void
+check_committed ()
+{
+    // runs after the pool was stopped, every queued job is done
+    if (counting_job::committed != 8)
+        {
+            printf ("FAIL: %d of 8 jobs committed at exit\n",
+                    counting_job::committed);
+            _Exit (1);
+        }
+
+    printf ("PASS: writer pool stopped at exit\n");
+}
+
+int
+main ()
+{
+    // registered first, so it runs last
+    atexit (check_committed);
+
+    async_writer_start (4, 16);
+    for (int i = 0; i < 8; i++)
+        async_writer_submit (std::unique_ptr<async_job> (new counting_job));
+
+    exit (0);
+}
@@ -0,0 +1,306 @@
+/*
+ * Round trip of the compact data value encoding: a type table is written
+ * with data_encoding=compact, read back with the decoding rules from the
+ * README and compared with the values it was written from.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "data_formatter.h"
+
+
+/* Just enough JSON for the formatter's own output.  */
+typedef struct _json_node
+{
+    enum { NUL, BOOL, NUMBER, STRING, ARRAY, MAP } kind = NUL;
+    bool boolean = false;
+    int number = 0;
+    std::string str;
+    std::vector<_json_node> items;
+    std::vector<std::string> keys;
+
+    const _json_node *
+    get (const char *key) const
+    {
+        for (size_t i = 0; i < keys.size (); i++)
+            if (keys[i] == key)
+                return &items[i];
+        return nullptr;
+    }
+} json_node_t;
+
+static bool parse_json (const char *&p, json_node_t &node);
+
+static bool
+parse_json_string (const char *&p, std::string &str)
+{
+    if (*p++ != '"')
+        return false;
+
+    while (*p && *p != '"')
+        {
+            if (*p == '\\')
+                {
+                    p++;
+                    switch (*p)
+                        {
+                        case 'n': str += '\n'; break;
+                        case 't': str += '\t'; break;
+                        case 'u':
+                            str += char (strtol (
+                                std::string (p + 1, 4).c_str (), nullptr, 16));
+                            p += 4;
+                            break;
+                        default: str += *p; break;
+                        }
+                    p++;
+                }
+            else
+                str += *p++;
+        }
+
+    return *p++ == '"';
+}
+
+static bool
+parse_json (const char *&p, json_node_t &node)
+{
+    while (*p == ' ' || *p == '\n')
+        p++;
+
+    if (*p == '"')
+        {
+            node.kind = json_node_t::STRING;
+            return parse_json_string (p, node.str);
+        }
+
+    if (*p == '[' || *p == '{')
+        {
+            bool is_map = *p++ == '{';
+            node.kind = is_map ? json_node_t::MAP : json_node_t::ARRAY;
+            for (;;)
+                {
+                    while (*p == ' ' || *p == '\n' || *p == ',')
+                        p++;
+                    if (*p == (is_map ? '}' : ']'))
+                        {
+                            p++;
+                            return true;
+                        }
+                    if (is_map)
+                        {
+                            node.keys.emplace_back ();
+                            if (!parse_json_string (p, node.keys.back ()))
+                                return false;
+                            while (*p == ' ' || *p == ':')
+                                p++;
+                        }
+                    node.items.emplace_back ();
+                    if (!parse_json (p, node.items.back ()))
+                        return false;
+                }
+        }
+
+    if (!strncmp (p, "true", 4) || !strncmp (p, "false", 5))
+        {
+            node.kind = json_node_t::BOOL;
+            node.boolean = *p == 't';
+            p += node.boolean ? 4 : 5;
+            return true;
+        }
+
+    if (!strncmp (p, "null", 4))
+        {
+            p += 4;
+            return true;
+        }
+
+    char *end;
+    node.kind = json_node_t::NUMBER;
+    node.number = strtol (p, &end, 10);
+    if (end == p)
+        return false;
+    p = end;
+    return true;
+}
+
+/* A decoded compact value, headers resolved.  */
+typedef struct _decoded_value
+{
+    std::string code_class;
+    std::string code_name;
+    bool is_expr = false;
+    int operand_length = 0;
+    int token = DATA_TOKEN_NONE;
+    int type_id = -1;
+    std::string simple_data_value;
+    std::vector<_decoded_value> complex_data_values;
+} decoded_value_t;
+
+static std::vector<decoded_value_t>
+decode_values (const json_node_t &list, const json_node_t &strings)
+{
+    std::vector<decoded_value_t> dvalues;
+    decoded_value_t last;
+
+    for (const json_node_t &item : list.items)
+        {
+            decoded_value_t dvalue;
+
+            if (item.kind == json_node_t::NUMBER)
+                dvalue.token = item.number;
+            else
+                {
+                    if (const json_node_t *h = item.get ("h"))
+                        {
+                            const json_node_t &code_class
+                                = strings.items[h->items[0].number];
+                            const json_node_t &code_name
+                                = strings.items[h->items[1].number];
+                            last.code_class = code_class.str;
+                            last.code_name = code_name.str;
+                            last.is_expr = h->items[2].boolean;
+                            last.operand_length = h->items[3].number;
+                        }
+                    if (const json_node_t *o = item.get ("o"))
+                        dvalue.token = o->number;
+                    if (const json_node_t *t = item.get ("t"))
+                        dvalue.type_id = t->number;
+                    if (const json_node_t *v = item.get ("v"))
+                        {
+                            if (v->kind == json_node_t::ARRAY)
+                                dvalue.complex_data_values
+                                    = decode_values (*v, strings);
+                            else
+                                dvalue.simple_data_value = v->str;
+                        }
+                }
+
+            dvalue.code_class = last.code_class;
+            dvalue.code_name = last.code_name;
+            dvalue.is_expr = last.is_expr;
+            dvalue.operand_length = last.operand_length;
+            dvalues.push_back (dvalue);
+        }
+
+    return dvalues;
+}
+
+static bool
+same_values (extract_vector<data_value_t> &expected,
+             const std::vector<decoded_value_t> &decoded)
+{
+    if (expected.size () != decoded.size ())
+        return false;
+
+    for (size_t i = 0; i < expected.size (); i++)
+        {
+            data_value_t &e = expected[i];
+            const decoded_value_t &d = decoded[i];
+
+            if (d.code_class != e.code_class || d.code_name != e.code_name
+                || d.is_expr != e.is_expr
+                || d.operand_length != int (e.operand_length)
+                || d.token != e.token)
+                return false;
+
+            if (e.token != DATA_TOKEN_NONE)
+                continue;
+
+            switch (e.value_type)
+                {
+                case DATA_VALUE_SIMPLE:
+                    if (d.simple_data_value != e.simple_data_value)
+                        return false;
+                    break;
+
+                case DATA_VALUE_COMPLEX:
+                    if (!same_values (e.complex_data_values,
+                                      d.complex_data_values))
+                        return false;
+                    break;
+
+                case DATA_VALUE_TYPE_REF:
+                    if (d.type_id != e.type_id)
+                        return false;
+                    break;
+                }
+        }
+
+    return true;
+}
+
+static data_value_t
+make_value (const char *code_class, const char *code_name,
+            unsigned int operand_length)
+{
+    data_value_t dvalue;
+    dvalue.code_class = code_class;
+    dvalue.code_name = code_name;
+    dvalue.operand_length = operand_length;
+    return dvalue;
+}
+
+int
+main ()
+{
+    static const char ref_class[] = "reference";
+    static const char mem_ref[] = "mem_ref";
+    static const char decl_class[] = "declaration";
+    static const char var_decl[] = "var_decl";
+
+    /* MEM[x_1 + 4], whose first nested value repeats the outer header and
+       whose trailing values follow a nested list with another header.  */
+    data_value_t outer = make_value (ref_class, mem_ref, 2);
+    outer.value_type = DATA_VALUE_COMPLEX;
+
+    data_value_t bracket = make_value (ref_class, mem_ref, 2);
+    bracket.token = DATA_TOKEN_LEFT_BRACKET;
+    bracket.simple_data_value = "[";
+    outer.complex_data_values.push_back (bracket);
+
+    data_value_t base = make_value (decl_class, var_decl, 0);
+    base.simple_data_value = "x_1";
+    outer.complex_data_values.push_back (base);
+
+    data_value_t type_ref = make_value (ref_class, mem_ref, 2);
+    type_ref.value_type = DATA_VALUE_TYPE_REF;
+    type_ref.type_id = 7;
+
+    data_value_t closing = make_value (ref_class, mem_ref, 2);
+    closing.token = DATA_TOKEN_RIGHT_BRACKET;
+    closing.simple_data_value = "]";
+
+    type_table_t type_table;
+    extract_vector<data_value_t> &values = type_table[1].values;
+    values.push_back (outer);
+    values.push_back (closing);
+    values.push_back (type_ref);
+
+    std::string out = type_table_to_string_dump (type_table, "json", "compact");
+
+    json_node_t root;
+    const char *p = out.c_str ();
+    if (!parse_json (p, root) || !root.get ("types") || !root.get ("strings"))
+        {
+            printf ("FAIL: unreadable output: %s\n", out.c_str ());
+            return 1;
+        }
+
+    const json_node_t &entry = root.get ("types")->items.at (0);
+    std::vector<decoded_value_t> decoded
+        = decode_values (*entry.get ("values"), *root.get ("strings"));
+
+    if (!same_values (values, decoded))
+        {
+            printf ("FAIL: round trip differs: %s\n", out.c_str ());
+            return 1;
+        }
+
+    printf ("PASS: compact encoding round trip\n");
+    return 0;
+}
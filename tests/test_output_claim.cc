@@ -0,0 +1,96 @@
+/*
+ * Dedup claims: who gets to write a claimed output, see claim_output_file.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "output_file.h"
+
+
+static int failures = 0;
+
+static void
+expect (bool ok, const char *what)
+{
+    if (!ok)
+        {
+            printf ("FAIL: %s\n", what);
+            failures++;
+        }
+}
+
+static enum output_claim
+claim (const std::string &path, const char *owner, const char *key)
+{
+    std::string error;
+    return claim_output_file (path, owner, key, error);
+}
+
+/* Pid of a process that has exited.  */
+static long
+get_finished_pid ()
+{
+    pid_t pid = fork ();
+    if (pid == 0)
+        _exit (0);
+
+    waitpid (pid, nullptr, 0);
+    return pid;
+}
+
+int
+main ()
+{
+    char dir[] = "/tmp/gimple_extractor_test.XXXXXX";
+    if (!mkdtemp (dir))
+        {
+            printf ("FAIL: cannot create %s\n", dir);
+            return 1;
+        }
+
+    std::string path = std::string (dir) + "/inline_fn.json";
+    std::string claim_path = path + ".claim";
+    std::string error;
+
+    expect (claim (path, "a.cc", "k1") == OUTPUT_CLAIM_TAKEN,
+            "first claim is taken");
+    expect (claim (path, "b.cc", "k1") == OUTPUT_CLAIM_HELD,
+            "claim of a running compilation is held");
+    expect (claim (path, "a.cc", "k1") == OUTPUT_CLAIM_TAKEN,
+            "the owner takes its claim again");
+    expect (claim (path, "b.cc", "k2") == OUTPUT_CLAIM_TAKEN,
+            "a changed body takes the claim over");
+
+    write_output_file (path, "{}", error);
+    expect (claim (path, "a.cc", "k2") == OUTPUT_CLAIM_HELD,
+            "claim of a written output is held");
+
+    // the claiming compiler died before writing the output
+    unlink (path.c_str ());
+    std::ofstream (claim_path) << "b.cc\nk2\n" << get_finished_pid () << "\n";
+    expect (claim (path, "a.cc", "k2") == OUTPUT_CLAIM_TAKEN,
+            "stale claim is taken over");
+
+    release_output_claim (path);
+    expect (access (claim_path.c_str (), F_OK) != 0, "claim is released");
+    expect (claim (path, "b.cc", "k2") == OUTPUT_CLAIM_TAKEN,
+            "released claim is taken");
+
+    expect (claim (std::string (dir) + "/missing/fn.json", "a.cc", "k1")
+                == OUTPUT_CLAIM_ERROR,
+            "claim in a missing directory fails");
+
+    release_output_claim (path);
+    rmdir (dir);
+
+    if (failures)
+        return 1;
+
+    printf ("PASS: output claims\n");
+    return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * With fsync=unit an output must not appear under its final path before
+ * sync_output_files () has flushed it.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include <unistd.h>
+
+#include "output_file.h"
+
+
+int
+main ()
+{
+    char dir[] = "/tmp/gimple_extractor_test.XXXXXX";
+    if (!mkdtemp (dir))
+        {
+            printf ("FAIL: cannot create %s\n", dir);
+            return 1;
+        }
+
+    std::string path = std::string (dir) + "/out.json";
+    std::string error;
+    config_fsync = OUTPUT_FSYNC_UNIT;
+
+    bool ok = write_output_file (path, "{}", error);
+    if (!ok || access (path.c_str (), F_OK) == 0)
+        {
+            printf ("FAIL: %s visible before sync %s\n", path.c_str (),
+                    error.c_str ());
+            return 1;
+        }
+
+    ok = sync_output_files (error);
+    bool visible = access (path.c_str (), F_OK) == 0;
+    unlink (path.c_str ());
+    rmdir (dir);
+
+    if (!ok || !visible)
+        {
+            printf ("FAIL: %s missing after sync %s\n", path.c_str (),
+                    error.c_str ());
+            return 1;
+        }
+
+    printf ("PASS: fsync=unit renames after syncing\n");
+    return 0;
+}
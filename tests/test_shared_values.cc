@@ -0,0 +1,101 @@
+/*
+ * A shared entry (a use of a cached tree description) must be written
+ * exactly like a copy of the values it refers to, in every encoding, while
+ * holding a single node instead of the copy.
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "data_formatter.h"
+
+
+static data_value_t
+make_simple_value (const char *code_name, const char *value)
+{
+    data_value_t dvalue;
+    dvalue.code_class = "declaration";
+    dvalue.code_name = code_name;
+    dvalue.simple_data_value = value;
+    return dvalue;
+}
+
+/* Nodes held by DVALUES, not counting the cached values that shared
+   entries refer to.  */
+static size_t
+count_owned_values (const extract_vector<data_value_t> &dvalues)
+{
+    size_t count = dvalues.size ();
+    for (auto &dvalue : dvalues)
+        count += count_owned_values (dvalue.complex_data_values);
+    return count;
+}
+
+int
+main ()
+{
+    // cached description of a declaration, used twice below
+    extract_vector<data_value_t> cached;
+    cached.push_back (make_simple_value ("var_decl", "x"));
+    cached.push_back (make_simple_value ("var_decl", "_1"));
+
+    data_value_t plus = make_simple_value ("plus_expr", "+");
+    plus.code_class = "binary";
+
+    data_value_t shared;
+    shared.shared_values = &cached;
+
+    data_value_t nested;
+    nested.code_class = "binary";
+    nested.code_name = "plus_expr";
+    nested.value_type = DATA_VALUE_COMPLEX;
+
+    type_table_t with_shared;
+    nested.complex_data_values.push_back (shared);
+    nested.complex_data_values.push_back (plus);
+    nested.complex_data_values.push_back (shared);
+    with_shared[1].values.push_back (nested);
+    with_shared[1].values.push_back (shared);
+
+    type_table_t with_copies;
+    nested.complex_data_values.clear ();
+    for (auto &dvalue : cached)
+        nested.complex_data_values.push_back (dvalue);
+    nested.complex_data_values.push_back (plus);
+    for (auto &dvalue : cached)
+        nested.complex_data_values.push_back (dvalue);
+    with_copies[1].values.push_back (nested);
+    for (auto &dvalue : cached)
+        with_copies[1].values.push_back (dvalue);
+
+    const char *formats[] = { "json", "msgpack" };
+    const char *encodings[] = { "verbose", "compact" };
+    for (const char *format : formats)
+        for (const char *encoding : encodings)
+            {
+                std::string shared_dump
+                    = type_table_to_string_dump (with_shared, format, encoding);
+                std::string copied_dump
+                    = type_table_to_string_dump (with_copies, format, encoding);
+                if (shared_dump != copied_dump)
+                    {
+                        printf ("FAIL: shared values differ in %s %s\n",
+                                format, encoding);
+                        return 1;
+                    }
+            }
+
+    // nested with its 3 values and the top level use; every use of the
+    // cached tree is 1 node where a copy is 2
+    size_t shared_count = count_owned_values (with_shared[1].values);
+    size_t copied_count = count_owned_values (with_copies[1].values);
+    if (shared_count != 5 || copied_count != 8)
+        {
+            printf ("FAIL: %zu nodes with shared values, %zu with copies\n",
+                    shared_count, copied_count);
+            return 1;
+        }
+
+    printf ("PASS: shared values are written in line\n");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#!/bin/sh
+# A header function compiled by two units: each time it is written, its
+# fn_type_table must name the types file of the unit that wrote it, and
+# every type_id it uses must be described there.
+
+: "${CXX:=g++}"
+: "${PLUGIN:=bin/gimple_extractor.so}"
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+mkdir "$dir/src" "$dir/out"
+
+cat > "$dir/src/shape.h" <<'END'
+struct shape { int width; int height; };
+inline int area (const shape *s) { return s->width * s->height; }
+END
+
+# different types ahead of the header, so that the units number them
+# differently
+cat > "$dir/src/a.cc" <<'END'
+#include "shape.h"
+struct point { long x; long y; };
+long first (point *p) { shape s = { 1, 2 }; return area (&s) + p->x; }
+END
+
+cat > "$dir/src/b.cc" <<'END'
+struct pair { char c; double d; };
+struct triple { pair p; short s; };
+#include "shape.h"
+double second (triple *t) { shape s = { 3, 4 }; return area (&s) + t->p.d; }
+END
+
+for unit in a b; do
+    "$CXX" -O0 -fplugin="$PLUGIN" \
+        -fplugin-arg-gimple_extractor-source_path="$dir/src" \
+        -fplugin-arg-gimple_extractor-output_path="$dir/out" \
+        -fplugin-arg-gimple_extractor-data_format=json \
+        -fplugin-arg-gimple_extractor-type_table=yes \
+        -c "$dir/src/$unit.cc" -o "$dir/$unit.o" || exit 1
+
+    output=$(find "$dir/out/shape_h" -name '*.json' | head -n 1)
+    if [ -z "$output" ]; then
+        echo "FAIL: no output for the header function of $unit.cc"
+        exit 1
+    fi
+
+    table=$(sed -n 's/.*"fn_type_table": "\([^"]*\)".*/\1/p' "$output")
+    case "$table" in
+    *"${unit}_cc.types.json") ;;
+    *)
+        echo "FAIL: $output names type table '$table' after $unit.cc"
+        exit 1
+        ;;
+    esac
+
+    for id in $(grep -o '"type_id": [0-9]*' "$output" | grep -o '[0-9]*$' \
+                | sort -u); do
+        if ! grep -q "\"type_id\": $id, \"values\"" "$dir/out/$table"; then
+            echo "FAIL: type $id of $output is not in $table"
+            exit 1
+        fi
+    done
+done
+
+echo "PASS: header function type ids resolve in their unit's table"